@@ -0,0 +1,50 @@
+import json
+import socket
+import struct
+from typing import Dict, List
+
+
+# Client for a long-lived `monopoly_engine --serve <socket>` process
+class EngineClient:
+    def __init__(self, socket_path: str, timeout: float = None):
+        self.socket_path = socket_path
+        self.timeout = timeout
+        self.sock = None
+
+    def connect(self):
+        if self.sock is None:
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            self.sock.settimeout(self.timeout)
+            self.sock.connect(self.socket_path)
+
+    def close(self):
+        if self.sock is not None:
+            self.sock.close()
+            self.sock = None
+
+    def _recv_exact(self, size: int) -> bytes:
+        chunks = []
+        while size > 0:
+            chunk = self.sock.recv(min(size, 1 << 20))
+            if not chunk:
+                raise ConnectionError("engine server closed the connection")
+            chunks.append(chunk)
+            size -= len(chunk)
+        return b''.join(chunks)
+
+    def run_games(self, configs: List[Dict]) -> List[Dict]:
+        # One frame out, one frame of NDJSON results back, in the same order as configs
+        self.connect()
+        try:
+            payload = json.dumps(configs).encode('utf-8')
+            self.sock.sendall(struct.pack('<I', len(payload)) + payload)
+            (size,) = struct.unpack('<I', self._recv_exact(4))
+            reply = self._recv_exact(size).decode('utf-8')
+        except Exception:
+            # Drop a connection left mid-frame, the next call reconnects
+            self.close()
+            raise
+        return [json.loads(line) for line in reply.splitlines() if line]
+
+    def run_game(self, config: Dict) -> Dict:
+        return self.run_games([config])[0]
@@ -0,0 +1,83 @@
+import argparse
+import pickle
+import struct
+
+import neat
+
+# Binary genome for the neat_native agent plugin, little-endian:
+#   header: magic 'NEAT', u32 version, u32 num_inputs, u32 num_outputs, u32 num_nodes, u32 num_evals
+#   per node eval, in evaluation order:
+#     u32 node slot, u8 activation, u8 aggregation, 2 pad bytes, f64 bias, f64 response, u32 num_links
+#     per link: u32 input slot, f64 weight
+# Slots 0..num_inputs-1 are the inputs, then the outputs, then hidden nodes.
+# Evaluation order and links come from neat.nn.FeedForwardNetwork.create, so native evaluation
+# matches net.activate() exactly.
+GENOME_MAGIC = b'NEAT'
+GENOME_VERSION = 1
+
+# Keep in sync with neat_native.c
+ACTIVATIONS = ['sigmoid', 'tanh', 'relu', 'identity', 'clamped', 'sin', 'gauss', 'abs', 'square', 'cube']
+AGGREGATIONS = ['sum', 'product', 'max', 'min', 'maxabs', 'mean']
+
+
+def function_id(func, names, defs, kind):
+    for i, name in enumerate(names):
+        if defs.get(name) is func:
+            return i
+    raise ValueError(f"{kind} function {func.__name__} not supported by neat_native")
+
+
+def export_genome(genome, config, out_path: str):
+    net = neat.nn.FeedForwardNetwork.create(genome, config)
+    genome_config = config.genome_config
+
+    slots = {}
+    for key in list(net.input_nodes) + list(net.output_nodes):
+        slots[key] = len(slots)
+    for node, _, _, _, _, links in net.node_evals:
+        for key in [node] + [input_node for input_node, _ in links]:
+            if key not in slots:
+                slots[key] = len(slots)
+
+    with open(out_path, 'wb') as f:
+        f.write(GENOME_MAGIC)
+        f.write(struct.pack('<IIIII', GENOME_VERSION, len(net.input_nodes), len(net.output_nodes), len(slots), len(net.node_evals)))
+        for node, act_func, agg_func, bias, response, links in net.node_evals:
+            f.write(struct.pack('<IBBxxddI',
+                                slots[node],
+                                function_id(act_func, ACTIVATIONS, genome_config.activation_defs, 'activation'),
+                                function_id(agg_func, AGGREGATIONS, genome_config.aggregation_function_defs, 'aggregation'),
+                                bias, response, len(links)))
+            for input_node, weight in links:
+                f.write(struct.pack('<Id', slots[input_node], weight))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Export a NEAT genome for the neat_native agent')
+    parser.add_argument('--config', type=str, default='agents/neat_config.txt', help='NEAT config file')
+    parser.add_argument('--genome', type=str, default='genomes/best_genome.pkl', help='Pickled genome')
+    parser.add_argument('--checkpoint', type=str, default=None, help='Export the fittest genome of a checkpoint instead')
+    parser.add_argument('--out', type=str, default='genomes/best_genome.bin', help='Output path')
+    args = parser.parse_args()
+
+    config = neat.Config(
+        neat.DefaultGenome,
+        neat.DefaultReproduction,
+        neat.DefaultSpeciesSet,
+        neat.DefaultStagnation,
+        args.config
+    )
+
+    if args.checkpoint:
+        p = neat.Checkpointer.restore_checkpoint(args.checkpoint)
+        _, genome = max(p.population.items(), key=lambda item: item[1].fitness if item[1].fitness is not None else float('-inf'))
+    else:
+        with open(args.genome, 'rb') as f:
+            genome = pickle.load(f)
+
+    export_genome(genome, config, args.out)
+    print(f"Exported genome to {args.out}")
+
+
+if __name__ == '__main__':
+    main()
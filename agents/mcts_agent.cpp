@@ -0,0 +1,507 @@
+#include "agent_abi.h"
+#include "engine.h"
+#include "json_reader.h"
+#include "log.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Monte Carlo Tree Search agent. Plays rollouts on copies of the game through the engine's own
+// rules (Engine(GameState, Policy)), with every player driven by a cheap default policy.
+// The tree covers this agent's actions within its current turn; each rollout then plays on for
+// "horizon" rounds. Root parallel: every thread grows its own tree, root visits are summed.
+// Config: {"rollouts": 500, "time_ms": 0, "threads": 1, "horizon": 20, "exploration": 1.4}
+
+namespace {
+
+struct MctsConfig {
+    uint32_t rollouts = 500;   // per decision, over all threads
+    uint32_t time_ms = 0;      // per decision, 0 = no limit
+    uint32_t threads = 1;      // 0 = all cores
+    uint32_t horizon = 20;     // rounds played past the decision
+    double exploration = 1.4;
+};
+
+struct MctsAgent {
+    MctsConfig cfg;
+    uint32_t agent_index = 0;
+    std::mt19937_64 rng;
+};
+
+Action make_action(ActionType type) {
+    Action action = {};
+    action.type = type;
+    return action;
+}
+
+uint64_t action_key(const Action& action) {
+    uint32_t param = 0;
+    switch (action.type) {
+    case ACTION_LANDED_PROPERTY:
+        param = action.buying_property;
+        break;
+    case ACTION_MORTGAGE:
+    case ACTION_UNMORTGAGE:
+    case ACTION_DEVELOP:
+    case ACTION_UNDEVELOP:
+        param = action.property_position;
+        break;
+    default:
+        break;
+    }
+    return (static_cast<uint64_t>(action.type) << 32) | param;
+}
+
+// Whole colour group owned by player and unmortgaged, as the engine requires for building
+bool owns_monopoly(const GameState& state, const ColourGroup& group, uint32_t player_index) {
+    return state.colour_owner[static_cast<size_t>(group.colour)] == player_index && state.is_monopoly(group.colour, true);
+}
+
+// Least developed property of each buildable monopoly, keeps building even
+std::vector<uint32_t> buildable_positions(const GameState& state, uint32_t player_index) {
+    const Board& b = board();
+    const PlayerView& player = state.players[player_index];
+    std::vector<uint32_t> positions;
+    for (const ColourGroup& group : b.colour_to_tiles) {
+        if (group.colour == Colour::None || group.count == 0 || !owns_monopoly(state, group, player_index)) {
+            continue;
+        }
+        const PropertyView* lowest = nullptr;
+        for (int i = 0; i < group.count; i++) {
+            const PropertyView& p = state.properties[b.ownableByTile(group.tiles[i])];
+            if (!lowest || p.houses < lowest->houses) {
+                lowest = &p;
+            }
+        }
+        if (lowest->houses >= 5 || player.cash < lowest->house_price) {
+            continue;
+        }
+        if (lowest->houses < 4 ? state.houses_remaining == 0 : state.hotels_remaining == 0) {
+            continue;
+        }
+        positions.push_back(lowest->position);
+    }
+    return positions;
+}
+
+// Decisions the search branches on. Jail options only while still sitting on the jail tile,
+// since paying the fine does not clear in_jail.
+std::vector<Action> candidate_actions(const GameState& state, uint32_t player_index) {
+    const Board& b = board();
+    const PlayerView& player = state.players[player_index];
+    std::vector<Action> actions;
+    actions.push_back(make_action(ACTION_END_TURN));
+
+    if (player.in_jail && player.position == b.jailPosition()) {
+        if (!player.jail_rolled_this_turn) {
+            actions.push_back(make_action(ACTION_JAIL_ROLL_DOUBLE));
+        }
+        if (player.cash >= 50) {
+            actions.push_back(make_action(ACTION_PAY_JAIL_FINE));
+        }
+        if (player.jail_free_cards > 0) {
+            actions.push_back(make_action(ACTION_USE_JAIL_CARD));
+        }
+    }
+
+    int index = b.ownableByTile(player.position);
+    if (index != -1) {
+        const PropertyView& property = state.properties[index];
+        if (!property.is_owned && !property.auctioned_this_turn && player.cash >= static_cast<uint32_t>(property.purchase_price)) {
+            Action buy = make_action(ACTION_LANDED_PROPERTY);
+            buy.buying_property = true;
+            actions.push_back(buy);
+        }
+    }
+
+    for (uint32_t position : buildable_positions(state, player_index)) {
+        Action develop = make_action(ACTION_DEVELOP);
+        develop.property_position = position;
+        actions.push_back(develop);
+    }
+    return actions;
+}
+
+// Rollout policy for every player: buy and build while keeping a cash reserve,
+// bid up to list price once, refuse trades
+class DefaultPolicy : public Policy {
+public:
+    Action agent_turn(const GameState& state, uint32_t player_index) override {
+        static constexpr uint32_t RESERVE = 150;
+        const Board& b = board();
+        const PlayerView& player = state.players[player_index];
+
+        int index = b.ownableByTile(player.position);
+        if (index != -1) {
+            const PropertyView& property = state.properties[index];
+            if (!property.is_owned && !property.auctioned_this_turn && player.cash >= property.purchase_price + RESERVE) {
+                Action buy = make_action(ACTION_LANDED_PROPERTY);
+                buy.buying_property = true;
+                return buy;
+            }
+        }
+
+        for (uint32_t position : buildable_positions(state, player_index)) {
+            const PropertyView& property = state.properties[b.ownableByTile(position)];
+            if (player.cash >= property.house_price + RESERVE) {
+                Action develop = make_action(ACTION_DEVELOP);
+                develop.property_position = position;
+                return develop;
+            }
+        }
+        return make_action(ACTION_END_TURN);
+    }
+
+    Action auction(const GameState& state, uint32_t player_index, const AuctionView& auction) override {
+        static constexpr uint32_t RESERVE = 100;
+        const PlayerView& player = state.players[player_index];
+        // property_id is the index into properties
+        const PropertyView& property = state.properties[auction.property_id];
+        uint32_t limit = std::min<uint32_t>(property.purchase_price, player.cash > RESERVE ? player.cash - RESERVE : 0);
+
+        Action bid = make_action(ACTION_AUCTION_BID);
+        bid.auction_bid = limit > auction.current_bid ? limit : 0;
+        return bid;
+    }
+
+    Action trade_offer(const GameState& state, uint32_t player_index, const TradeOffer& offer) override {
+        Action response = make_action(ACTION_TRADE_RESPONSE);
+        response.trade_response = false;
+        return response;
+    }
+};
+
+double worth(const GameState& state, uint32_t player_index) {
+    double total = state.players[player_index].cash;
+    for (uint32_t bits = state.owned_by(player_index); bits; bits &= bits - 1) {
+        const uint32_t index = std::countr_zero(bits);
+        const OwnableInfo& info = board().ownables[index];
+        total += state.is_mortgaged(index) ? info.purchase_price / 2.0 : info.purchase_price;
+        if (info.type == TileType::Property) {
+            total += info.house_cost * state.houses[index];
+        }
+    }
+    return total;
+}
+
+// Share of the remaining players' worth, 1 for a sole survivor, 0 once retired
+double evaluate(const GameState& state, uint32_t player_index) {
+    if (state.players[player_index].retired) {
+        return 0;
+    }
+    double mine = worth(state, player_index);
+    double total = 0;
+    for (const PlayerView& p : state.seated_players()) {
+        if (!p.retired) {
+            total += worth(state, p.player_index);
+        }
+    }
+    return total > 0 ? mine / total : 1;
+}
+
+// Deck order is hidden from agents, so every rollout draws from a fresh shuffle.
+// Held jail cards are taken out of the decks (community first, matching use_jail_free_card).
+void sample_decks(GameState& state, std::mt19937_64& rng) {
+    uint32_t held = 0;
+    for (const PlayerView& p : state.seated_players()) {
+        held += p.jail_free_cards;
+    }
+    const std::pair<CardDeck*, uint32_t> decks[] = {{&state.community_deck, GameState::COMMUNITY_JAIL_CARD},
+                                                    {&state.chance_deck, GameState::CHANCE_JAIL_CARD}};
+    for (int d = 0; d < 2; d++) {
+        CardDeck& deck = *decks[d].first;
+        deck.head = 0;
+        deck.count = 0;
+        deck.jail_card_out = held > static_cast<uint32_t>(d);
+        for (uint32_t card = 0; card < CardDeck::CAPACITY; card++) {
+            if (card == decks[d].second && deck.jail_card_out) {
+                continue;
+            }
+            deck.push_back(card);
+        }
+        deck.shuffle(rng);
+    }
+}
+
+bool state_from_view(const GameStateView& view, uint32_t player_index, uint32_t horizon, GameState& state) {
+    if (view.players_remaining > GameState::MAX_PLAYERS || view.num_properties != GameState::NUM_PROPERTIES || player_index >= view.players_remaining) {
+        return false;
+    }
+    state = GameState{};
+    state.game_id = view.game_id;
+    state.houses_remaining = view.houses_remaining;
+    state.hotels_remaining = view.hotels_remaining;
+    state.current_player_index = view.current_player_index;
+    state.num_players = view.players_remaining;
+    state.owed = view.owed;
+    std::copy(view.players, view.players + view.players_remaining, state.players.begin());
+    std::copy(view.properties, view.properties + view.num_properties, state.properties.begin());
+    state.rebuild_masks();
+
+    state.turn = 0;
+    state.max_turns = horizon;
+    state.active_player = player_index;
+    return true;
+}
+
+struct Node {
+    Action action = {};
+    uint64_t key = 0;
+    uint32_t visits = 0;
+    double value = 0;
+    std::vector<std::unique_ptr<Node>> children;
+};
+
+struct SearchSlice {
+    uint32_t rollouts;
+    uint64_t seed;
+};
+
+// One root-parallel worker: grows its own tree and reports root child visits per action key
+std::unordered_map<uint64_t, uint32_t> search(const GameState& root, uint32_t me, const MctsConfig& cfg,
+                                              SearchSlice slice, std::chrono::steady_clock::time_point deadline) {
+    DefaultPolicy policy;
+    std::mt19937_64 rng(slice.seed);
+    Node root_node;
+
+    for (uint32_t iteration = 0; iteration < slice.rollouts; iteration++) {
+        if (cfg.time_ms > 0 && iteration > 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        GameState sim = root;
+        sim.rng.reseed(rng());
+        sample_decks(sim, rng);
+        Engine engine(sim, policy);
+
+        // Selection / expansion over this agent's actions until its turn ends
+        std::vector<Node*> path{&root_node};
+        Node* node = &root_node;
+        bool turn_over = false;
+        while (!turn_over) {
+            std::vector<Action> actions = candidate_actions(engine.state(), me);
+            Node* next = nullptr;
+            bool expanded = false;
+            for (const Action& action : actions) {
+                uint64_t key = action_key(action);
+                auto it = std::find_if(node->children.begin(), node->children.end(),
+                                       [key](const std::unique_ptr<Node>& child) { return child->key == key; });
+                if (it == node->children.end()) {
+                    auto child = std::make_unique<Node>();
+                    child->action = action;
+                    child->key = key;
+                    next = child.get();
+                    node->children.push_back(std::move(child));
+                    expanded = true;
+                    break;
+                }
+            }
+            if (!next) {
+                double best = -1;
+                double log_visits = std::log(static_cast<double>(node->visits) + 1);
+                for (const Action& action : actions) {
+                    uint64_t key = action_key(action);
+                    for (auto& child : node->children) {
+                        if (child->key != key) {
+                            continue;
+                        }
+                        double ucb = child->value / child->visits + cfg.exploration * std::sqrt(log_visits / child->visits);
+                        if (ucb > best) {
+                            best = ucb;
+                            next = child.get();
+                        }
+                    }
+                }
+            }
+            path.push_back(next);
+            turn_over = engine.apply_action(next->action);
+            node = next;
+            if (expanded) {
+                break;
+            }
+        }
+
+        // Rollout: finish the turn and play on with the default policy
+        if (!turn_over) {
+            while (!engine.apply_action(policy.agent_turn(engine.state(), me))) {
+            }
+        }
+        engine.end_turn();
+        while (!engine.game_over()) {
+            engine.play_turn();
+        }
+
+        double value = evaluate(engine.state(), me);
+        for (Node* n : path) {
+            n->visits++;
+            n->value += value;
+        }
+    }
+
+    std::unordered_map<uint64_t, uint32_t> visits;
+    for (auto& child : root_node.children) {
+        visits[child->key] += child->visits;
+    }
+    return visits;
+}
+
+Action choose_action(MctsAgent* agent, const GameStateView* view) {
+    GameState root;
+    if (!state_from_view(*view, agent->agent_index, agent->cfg.horizon, root)) {
+        return make_action(ACTION_END_TURN);
+    }
+    std::vector<Action> actions = candidate_actions(root, agent->agent_index);
+    if (actions.size() == 1) {
+        return actions[0];
+    }
+
+    const MctsConfig& cfg = agent->cfg;
+    uint32_t threads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1u, std::min(threads, cfg.rollouts));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(cfg.time_ms);
+
+    // Worker t always gets stream t of this decision's seed, whatever thread ran before it
+    const uint64_t decision_seed = agent->rng();
+    std::vector<SearchSlice> slices(threads);
+    for (uint32_t t = 0; t < threads; t++) {
+        slices[t] = {cfg.rollouts / threads + (t < cfg.rollouts % threads ? 1 : 0), derive_seed(decision_seed, t)};
+    }
+
+    std::vector<std::unordered_map<uint64_t, uint32_t>> results(threads);
+    std::vector<std::thread> workers;
+    for (uint32_t t = 1; t < threads; t++) {
+        workers.emplace_back([&, t] { results[t] = search(root, agent->agent_index, cfg, slices[t], deadline); });
+    }
+    results[0] = search(root, agent->agent_index, cfg, slices[0], deadline);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    Action best = actions[0];
+    uint32_t best_visits = 0;
+    for (const Action& action : actions) {
+        uint64_t key = action_key(action);
+        uint32_t visits = 0;
+        for (const auto& result : results) {
+            auto it = result.find(key);
+            if (it != result.end()) {
+                visits += it->second;
+            }
+        }
+        if (visits > best_visits) {
+            best_visits = visits;
+            best = action;
+        }
+    }
+    return best;
+}
+
+uint32_t config_u32(const JsonValue& config, const char* key, uint32_t fallback) {
+    const JsonValue* value = config.find(key);
+    return value ? static_cast<uint32_t>(value->as_u64(key)) : fallback;
+}
+
+}
+
+extern "C" {
+
+int abi_version() {
+    return ABI_VERSION;
+}
+
+void* create_agent(const char* config_json) {
+    auto agent = std::make_unique<MctsAgent>();
+    try {
+        JsonValue config = parse_json(config_json && *config_json ? config_json : "{}");
+        agent->cfg.rollouts = std::max(1u, config_u32(config, "rollouts", agent->cfg.rollouts));
+        agent->cfg.time_ms = config_u32(config, "time_ms", agent->cfg.time_ms);
+        agent->cfg.threads = config_u32(config, "threads", agent->cfg.threads);
+        agent->cfg.horizon = std::max(1u, config_u32(config, "horizon", agent->cfg.horizon));
+        if (const JsonValue* exploration = config.find("exploration")) {
+            agent->cfg.exploration = std::stod(exploration->text);
+        }
+    } catch (const std::exception& e) {
+        LOG(ERROR, "mcts_agent: bad config: ", e.what());
+        return nullptr;
+    }
+    return agent.release();
+}
+
+void destroy_agent(void* agent_ptr) {
+    delete static_cast<MctsAgent*>(agent_ptr);
+}
+
+void game_start(void* agent_ptr, uint32_t agent_index, uint64_t seed) {
+    MctsAgent* agent = static_cast<MctsAgent*>(agent_ptr);
+    if (!agent) {
+        return;
+    }
+    agent->agent_index = agent_index;
+    agent->rng.seed(seed);
+}
+
+Action agent_turn(void* agent_ptr, const GameStateView* state) {
+    MctsAgent* agent = static_cast<MctsAgent*>(agent_ptr);
+    if (!agent || !state) {
+        return make_action(ACTION_END_TURN);
+    }
+    return choose_action(agent, state);
+}
+
+Action auction(void* agent_ptr, const GameStateView* state, const AuctionView* auction) {
+    MctsAgent* agent = static_cast<MctsAgent*>(agent_ptr);
+    Action bid = make_action(ACTION_AUCTION_BID);
+    bid.auction_bid = 0;
+    if (!agent || !state || !auction || auction->property_id >= state->num_properties) {
+        return bid;
+    }
+    const PlayerView& player = state->players[agent->agent_index];
+    const PropertyView& property = state->properties[auction->property_id];
+
+    // List price, more for a street that completes or blocks a colour group
+    double value = property.purchase_price;
+    if (property.type == PropertyType::PROPERTY) {
+        const ColourGroup& group = board().tilesOfColour(static_cast<Colour>(property.colour_id));
+        for (int i = 0; i < group.count; i++) {
+            const PropertyView& p = state->properties[board().ownableByTile(group.tiles[i])];
+            if (p.position != property.position && p.is_owned) {
+                value *= 1.25;
+            }
+        }
+    }
+    uint32_t limit = std::min<uint32_t>(static_cast<uint32_t>(value), player.cash > 100 ? player.cash - 100 : 0);
+    if (auction->proxy) {
+        bid.auction_bid = limit;
+    } else if (limit > auction->current_bid) {
+        bid.auction_bid = std::min(limit, auction->current_bid + 10);
+    }
+    return bid;
+}
+
+Action trade_offer(void* agent_ptr, const GameStateView* state, const TradeOffer* offer) {
+    Action response = make_action(ACTION_TRADE_RESPONSE);
+    response.trade_response = false;
+    return response;
+}
+
+AGENT_API AgentExport create_agent_export(const char* config_json) {
+    AgentExport exported = {};
+    exported.vtable.abi_version = abi_version;
+    exported.vtable.create_agent = create_agent;
+    exported.vtable.destroy_agent = destroy_agent;
+    exported.vtable.game_start = game_start;
+    exported.vtable.agent_turn = agent_turn;
+    exported.vtable.auction = auction;
+    exported.vtable.trade_offer = trade_offer;
+    exported.vtable.flags = AGENT_FLAG_THREAD_SAFE;
+    return exported;
+}
+
+}
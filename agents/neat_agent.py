@@ -350,8 +350,15 @@ class NEATAgent:
         
         return trade_offer
 
-    def agent_turn(self, state) -> Dict:        
-        features = self.extract_features(state)
+    def native_features(self, features) -> np.ndarray:
+        # Buffer filled by neat_features.c in the bridge, only valid during the current call
+        return np.frombuffer(features, dtype=np.float32)
+
+    def agent_turn(self, state, features=None) -> Dict:
+        if features is None:
+            features = self.extract_features(state)
+        else:
+            features = self.native_features(features)
         output = self.net.activate(features)
         ''' 
         output[0] -> trade acceptance score, 
@@ -421,7 +428,7 @@ class NEATAgent:
             return {'action_type': 8 } # ACTION_END_TURN
 
             
-    def auction(self, state: Dict, auction: Dict) -> Dict:
+    def auction(self, state: Dict, auction: Dict, features=None) -> Dict:
         agent_player = state['players'][self.agent_index]
         property_id = auction['property_id']
 
@@ -435,7 +442,10 @@ class NEATAgent:
         if not prop:
             return {'action_type': 8}  # END_TURN (no bid)
         
-        features = self.extract_features(state, action='auction')
+        if features is None:
+            features = self.extract_features(state, action='auction')
+        else:
+            features = self.native_features(features)
         output = self.net.activate(features)
         
         # Bid based on neural network output and property value (output[1])
@@ -449,11 +459,14 @@ class NEATAgent:
                 'auction_bid': bid
             }
     
-    def trade_offer(self, state: Dict, offer: Dict) -> Dict:
+    def trade_offer(self, state: Dict, offer: Dict, features=None) -> Dict:
         # Respond to trade offer
         # Use neural network to evaluate trade
 
-        features = self.extract_features(state, trade_offer=offer, action='trade_offer')
+        if features is None:
+            features = self.extract_features(state, trade_offer=offer, action='trade_offer')
+        else:
+            features = self.native_features(features)
         output = self.net.activate(features)
         
         # output[2] -> trade acceptance score
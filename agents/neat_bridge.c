@@ -1,6 +1,7 @@
 // AI-Generated NEAT bridge agent with Claude Sonnet 4.5 
 #include "agent_abi.h"
 #include "state_view.h"
+#include "neat_features.h"
 #include <Python.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -13,6 +14,7 @@ typedef struct {
     uint64_t seed;
     PyObject* neat_module;
     PyObject* neat_instance;
+    float features[NEAT_NUM_INPUTS]; // shared with Python for the duration of one call
     char name[64];
 } NEATAgent;
 
@@ -101,21 +103,37 @@ static PyObject* trade_to_python(const TradeOffer* offer) {
     return py_offer;
 }
 
+// Features computed in C, exposed zero-copy as a read-only memoryview over agent->features
+// (Python wraps it with np.frombuffer). None if the agent is not in the state, Python then fails as before.
+static PyObject* features_to_python(NEATAgent* agent, const GameStateView* state, NeatDecision decision, const TradeOffer* offer) {
+    if (!neat_extract_features(state, agent->agent_index, decision, offer, agent->features)) {
+        Py_RETURN_NONE;
+    }
+    return PyMemoryView_FromMemory((char*)agent->features, sizeof(agent->features), PyBUF_READ);
+}
+
 int abi_version() {
     return ABI_VERSION;
 }
 
 void* create_agent(const char* config_json) {
     if (!python_initialized) {
-        Py_Initialize();
         python_initialized = 1;
-        
+        if (!Py_IsInitialized()) {
+            Py_Initialize();
+            // Drop the GIL so any engine thread can take it with PyGILState_Ensure
+            PyEval_SaveThread();
+        }
+        PyGILState_STATE gil = PyGILState_Ensure();
         // Add current directory to Python path
         PyRun_SimpleString("import sys; sys.path.insert(0, './agents')");
+        PyGILState_Release(gil);
     }
     
     NEATAgent* agent = (NEATAgent*)malloc(sizeof(NEATAgent));
     if (!agent) return NULL;
+
+    PyGILState_STATE gil = PyGILState_Ensure();
     
     agent->agent_index = 0;
     agent->seed = 0;
@@ -127,6 +145,7 @@ void* create_agent(const char* config_json) {
     if (!agent->neat_module) {
         PyErr_Print();
         free(agent);
+        PyGILState_Release(gil);
         return NULL;
     }
     
@@ -136,6 +155,7 @@ void* create_agent(const char* config_json) {
         PyErr_Print();
         Py_DECREF(agent->neat_module);
         free(agent);
+        PyGILState_Release(gil);
         return NULL;
     }
     
@@ -149,17 +169,21 @@ void* create_agent(const char* config_json) {
         PyErr_Print();
         Py_DECREF(agent->neat_module);
         free(agent);
+        PyGILState_Release(gil);
         return NULL;
     }
     
+    PyGILState_Release(gil);
     return agent;
 }
 
 void destroy_agent(void* agent_ptr) {
     if (agent_ptr) {
         NEATAgent* agent = (NEATAgent*)agent_ptr;
+        PyGILState_STATE gil = PyGILState_Ensure();
         if (agent->neat_instance) Py_DECREF(agent->neat_instance);
         if (agent->neat_module) Py_DECREF(agent->neat_module);
+        PyGILState_Release(gil);
         free(agent);
     }
 }
@@ -172,10 +196,12 @@ void game_start(void* agent_ptr, uint32_t agent_index, uint64_t seed) {
     agent->seed = seed;
     
     // Call Python: agent.game_start(agent_index, seed)
+    PyGILState_STATE gil = PyGILState_Ensure();
     PyObject* result = PyObject_CallMethod(agent->neat_instance, "game_start", "IK", 
                                           agent_index, seed);
     if (result) Py_DECREF(result);
     else PyErr_Print();
+    PyGILState_Release(gil);
 }
 
 Action agent_turn(void* agent_ptr, const GameStateView* state) {
@@ -185,12 +211,16 @@ Action agent_turn(void* agent_ptr, const GameStateView* state) {
     
     if (!agent || !state) return action;
     
+    PyGILState_STATE gil = PyGILState_Ensure();
     PyObject* py_state = state_to_python(state, agent->agent_index);
-    PyObject* result = PyObject_CallMethod(agent->neat_instance, "agent_turn", "O", py_state);
+    PyObject* py_features = features_to_python(agent, state, NEAT_DECISION_TURN, NULL);
+    PyObject* result = PyObject_CallMethod(agent->neat_instance, "agent_turn", "OO", py_state, py_features);
     Py_DECREF(py_state);
+    Py_DECREF(py_features);
     
     if (!result) {
         PyErr_Print();
+        PyGILState_Release(gil);
         return action;
     }
     
@@ -215,6 +245,7 @@ Action agent_turn(void* agent_ptr, const GameStateView* state) {
     }
     
     Py_DECREF(result);
+    PyGILState_Release(gil);
     return action;
 }
 
@@ -225,15 +256,19 @@ Action auction(void* agent_ptr, const GameStateView* state, const AuctionView* a
     
     if (!agent || !state || !auction) return action;
     
+    PyGILState_STATE gil = PyGILState_Ensure();
     PyObject* py_state = state_to_python(state, agent->agent_index);
     PyObject* py_auction = auction_to_python(auction);
-    PyObject* result = PyObject_CallMethod(agent->neat_instance, "auction", "OO", 
-                                          py_state, py_auction);
+    PyObject* py_features = features_to_python(agent, state, NEAT_DECISION_AUCTION, NULL);
+    PyObject* result = PyObject_CallMethod(agent->neat_instance, "auction", "OOO",
+                                          py_state, py_auction, py_features);
     Py_DECREF(py_state);
     Py_DECREF(py_auction);
+    Py_DECREF(py_features);
     
     if (!result) {
         PyErr_Print();
+        PyGILState_Release(gil);
         return action;
     }
     
@@ -247,6 +282,7 @@ Action auction(void* agent_ptr, const GameStateView* state, const AuctionView* a
     }
     
     Py_DECREF(result);
+    PyGILState_Release(gil);
     return action;
 }
 
@@ -258,15 +294,19 @@ Action trade_offer(void* agent_ptr, const GameStateView* state, const TradeOffer
     
     if (!agent || !state || !offer) return action;
     
+    PyGILState_STATE gil = PyGILState_Ensure();
     PyObject* py_state = state_to_python(state, agent->agent_index);
     PyObject* py_offer = trade_to_python(offer);
-    PyObject* result = PyObject_CallMethod(agent->neat_instance, "trade_offer", "OO",
-                                          py_state, py_offer);
+    PyObject* py_features = features_to_python(agent, state, NEAT_DECISION_TRADE, offer);
+    PyObject* result = PyObject_CallMethod(agent->neat_instance, "trade_offer", "OOO",
+                                          py_state, py_offer, py_features);
     Py_DECREF(py_state);
     Py_DECREF(py_offer);
+    Py_DECREF(py_features);
     
     if (!result) {
         PyErr_Print();
+        PyGILState_Release(gil);
         return action;
     }
     
@@ -274,6 +314,7 @@ Action trade_offer(void* agent_ptr, const GameStateView* state, const TradeOffer
     action.trade_response = response ? PyObject_IsTrue(response) : false;
     
     Py_DECREF(result);
+    PyGILState_Release(gil);
     return action;
 }
 
@@ -284,7 +325,8 @@ AgentVTable vtable = {
     .game_start = game_start,
     .agent_turn = agent_turn,
     .auction = auction,
-    .trade_offer = trade_offer
+    .trade_offer = trade_offer,
+    .flags = 0 // embedded interpreter is process-wide
 };
 
 AGENT_API AgentExport create_agent_export(const char* config_json) {
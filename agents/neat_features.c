@@ -0,0 +1,146 @@
+// Feature extraction shared by neat_native and neat_bridge, one pass over players and properties.
+// Mirrors NEATAgent.extract_features; fields the bridge never put in the Python dicts
+// (rent0..rentH, house_price, is_monopoly, auctioned_this_turn, trade property lists) count as 0.
+#include "neat_features.h"
+#include <string.h>
+
+int neat_extract_features(const GameStateView* state, uint32_t agent_index, NeatDecision decision,
+                          const TradeOffer* offer, float* features) {
+    const PlayerView* agent_player = NULL;
+    uint32_t num_opponents = 0;
+    double opp_cash_sum = 0.0;
+    uint32_t max_opp_cash = 0;
+    uint32_t active_opponents = 0;
+    double total_wealth = 0.0;
+
+    for (uint32_t i = 0; i < state->players_remaining; i++) {
+        const PlayerView* p = &state->players[i];
+        total_wealth += p->cash;
+        if (p->player_index == agent_index) {
+            agent_player = p;
+            continue;
+        }
+        opp_cash_sum += p->cash;
+        if (num_opponents == 0 || p->cash > max_opp_cash) max_opp_cash = p->cash;
+        if (!p->retired) active_opponents++;
+        num_opponents++;
+    }
+    if (!agent_player) return 0;
+
+    size_t n = 0;
+    memset(features, 0, NEAT_NUM_INPUTS * sizeof(float));
+
+    features[n++] = decision == NEAT_DECISION_TRADE ? 1.0f : 0.0f;
+    features[n++] = decision == NEAT_DECISION_AUCTION ? 1.0f : 0.0f;
+    features[n++] = (float)(agent_player->player_index / 3.0);
+    features[n++] = (float)(agent_index / 3.0);
+    features[n++] = (float)(agent_player->cash / 2000.0);
+    features[n++] = (float)(agent_player->position / 40.0);
+    features[n++] = agent_player->in_jail ? 1.0f : 0.0f;
+    features[n++] = (float)(agent_player->turns_in_jail / 3.0);
+    features[n++] = (float)(agent_player->jail_free_cards / 2.0);
+    features[n++] = (float)(agent_player->railroads_owned / 4.0);
+    features[n++] = (float)(agent_player->utilities_owned / 2.0);
+
+    // Ownership by colour, development and opponent property counts
+    uint32_t colour_counts[9] = {0};
+    uint32_t colour_total[256] = {0};
+    uint32_t colour_ours[256] = {0};
+    uint32_t total_houses = 0, total_hotels = 0, unowned = 0, opp_properties = 0;
+    int64_t total_property_value = 0;
+    const PropertyView* property_at_position = NULL;
+
+    for (uint32_t i = 0; i < state->num_properties; i++) {
+        const PropertyView* prop = &state->properties[i];
+        if (prop->owner_index == agent_index) {
+            if (prop->colour_id < 9) colour_counts[prop->colour_id]++;
+            total_houses += prop->houses;
+            total_hotels += prop->hotel ? 1 : 0;
+            total_property_value += prop->purchase_price;
+        }
+        if (prop->owner_index != agent_index && prop->is_owned) opp_properties++;
+        if (!prop->is_owned) unowned++;
+        colour_total[prop->colour_id]++;
+        if (prop->is_owned && prop->owner_index == agent_index) colour_ours[prop->colour_id]++;
+        if (!property_at_position && prop->position == agent_player->position) property_at_position = prop;
+    }
+
+    for (int c = 0; c < 9; c++) {
+        features[n++] = (float)(colour_counts[c] / 3.0);
+    }
+    features[n++] = (float)(total_houses / 32.0);
+    features[n++] = (float)(total_hotels / 12.0);
+    features[n++] = (float)(total_property_value / 10000.0);
+
+    if (num_opponents) {
+        features[n++] = (float)(opp_cash_sum / num_opponents / 2000.0);
+        features[n++] = (float)((double)opp_properties / num_opponents / 28.0);
+        features[n++] = (float)(max_opp_cash / 2000.0);
+        features[n++] = (float)(active_opponents / 3.0);
+    } else {
+        n += 4;
+    }
+
+    features[n++] = (float)(unowned / 28.0);
+    features[n++] = (float)(state->houses_remaining / 32.0);
+    features[n++] = (float)(state->hotels_remaining / 12.0);
+    features[n++] = (float)(agent_player->cash / (total_wealth > 1.0 ? total_wealth : 1.0));
+    features[n++] = (float)(state->owed / 2000.0);
+
+    // Property at our position; rents, house price and flags neat_bridge does not pass stay 0
+    if (property_at_position) {
+        const PropertyView* prop = property_at_position;
+        uint32_t total_in_group = colour_total[prop->colour_id];
+        features[n++] = (float)(prop->purchase_price / 400.0);
+        features[n++] = (float)(prop->colour_id / 8.0);
+        features[n++] = prop->type == PROPERTY ? 1.0f : 0.0f;
+        features[n++] = prop->type == UTILITY ? 1.0f : 0.0f;
+        features[n++] = prop->type == RAILROAD ? 1.0f : 0.0f;
+        features[n++] = prop->is_owned ? 1.0f : 0.0f;
+        features[n++] = prop->owner_index == agent_index ? 1.0f : 0.0f;
+        features[n++] = (float)((double)colour_ours[prop->colour_id] / (total_in_group > 1 ? total_in_group : 1));
+        features[n++] = (float)(((int64_t)agent_player->cash - prop->purchase_price) / 2000.0);
+        features[n++] = (float)(prop->current_rent / 2000.0);
+        n += 6; // rent0..rentH
+        features[n++] = (float)(prop->houses / 4.0);
+        features[n++] = prop->hotel ? 1.0f : 0.0f;
+        features[n++] = prop->mortgaged ? 1.0f : 0.0f;
+        n += 3; // is_monopoly, auctioned_this_turn, house_price
+    } else {
+        n += 22;
+    }
+
+    // Trade offer, neat_bridge passes cash and jail cards only
+    if (decision == NEAT_DECISION_TRADE && offer) {
+        int64_t cash_gain = (int64_t)offer->offer_to.cash - offer->offer_from.cash;
+        features[n++] = (float)(cash_gain / 2000.0);
+        n += 5; // property counts, railroads, utilities, monopoly potential
+        features[n++] = (float)(offer->offer_to.jail_cards / 2.0);
+        features[n++] = (float)(offer->offer_from.jail_cards / 2.0);
+        features[n++] = cash_gain > 0 ? 1.0f : 0.0f;
+        n += 2; // more properties received, completes monopoly
+        features[n++] = (float)((agent_player->cash + cash_gain) / 2000.0);
+    } else {
+        n += 15;
+    }
+
+    // Completed colour groups
+    uint32_t monopoly_count = 0, developable = 0, max_houses = 0;
+    int64_t monopoly_value = 0;
+    for (uint32_t i = 0; i < state->num_properties; i++) {
+        const PropertyView* prop = &state->properties[i];
+        if (colour_ours[prop->colour_id] != colour_total[prop->colour_id]) continue;
+        monopoly_value += prop->purchase_price;
+        if (prop->houses < 5) developable++;
+        if (prop->houses > max_houses) max_houses = prop->houses;
+    }
+    for (int c = 0; c < 256; c++) {
+        if (colour_total[c] && colour_ours[c] == colour_total[c]) monopoly_count++;
+    }
+    features[n++] = (float)(monopoly_count / 8.0);
+    features[n++] = (float)(monopoly_value / 10000.0);
+    features[n++] = (float)(developable / 12.0);
+    features[n++] = (float)(max_houses / 5.0);
+    features[n++] = state->houses_remaining > 0 ? 1.0f : 0.0f;
+    return 1;
+}
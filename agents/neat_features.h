@@ -0,0 +1,23 @@
+#pragma once
+#include "state_view.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NEAT_NUM_INPUTS 80
+
+typedef enum {
+    NEAT_DECISION_TURN,
+    NEAT_DECISION_AUCTION,
+    NEAT_DECISION_TRADE
+} NeatDecision;
+
+// Fills features[NEAT_NUM_INPUTS] exactly as NEATAgent.extract_features does for the state neat_bridge
+// passes to Python. offer is only read for NEAT_DECISION_TRADE. Returns 0 if agent_index is not in state.
+int neat_extract_features(const GameStateView* state, uint32_t agent_index, NeatDecision decision,
+                          const TradeOffer* offer, float* features);
+
+#ifdef __cplusplus
+}
+#endif
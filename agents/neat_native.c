@@ -0,0 +1,401 @@
+#include "agent_abi.h"
+#include "state_view.h"
+#include "neat_features.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// NEAT agent evaluated natively, no Python involved.
+// Loads a genome written by agents/export_genome.py (config: {"genome_path": "genomes/best_genome.bin"})
+// and makes the same decisions as neat_agent.py driven through neat_bridge.
+
+#define NEAT_NUM_OUTPUTS 38
+#define GENOME_VERSION 1
+
+// Ids written by export_genome.py
+enum { ACT_SIGMOID, ACT_TANH, ACT_RELU, ACT_IDENTITY, ACT_CLAMPED, ACT_SIN, ACT_GAUSS, ACT_ABS, ACT_SQUARE, ACT_CUBE };
+enum { AGG_SUM, AGG_PRODUCT, AGG_MAX, AGG_MIN, AGG_MAXABS, AGG_MEAN };
+
+typedef struct {
+    uint32_t node;
+    uint8_t activation;
+    uint8_t aggregation;
+    double bias;
+    double response;
+    uint32_t first_link;
+    uint32_t num_links;
+} NodeEval;
+
+typedef struct {
+    uint32_t num_nodes;
+    uint32_t num_evals;
+    NodeEval* evals;
+    uint32_t* link_inputs;
+    double* link_weights;
+    double* values; // one slot per node, inputs first then outputs
+} NeatNetwork;
+
+typedef struct {
+    uint32_t agent_index;
+    uint64_t seed;
+    NeatNetwork net;
+    char name[64];
+} NEATNativeAgent;
+
+// Pulls a string value out of the flat agent config, e.g. "genome_path"
+static int config_string(const char* config_json, const char* key, char* out, size_t out_size) {
+    if (!config_json) return 0;
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    const char* p = strstr(config_json, pattern);
+    if (!p) return 0;
+    p = strchr(p + strlen(pattern), ':');
+    if (!p) return 0;
+    p = strchr(p, '"');
+    if (!p) return 0;
+    p++;
+
+    size_t n = 0;
+    while (*p && *p != '"' && n + 1 < out_size) {
+        if (*p == '\\' && p[1]) p++;
+        out[n++] = *p++;
+    }
+    out[n] = '\0';
+    return *p == '"';
+}
+
+static int read_u32(FILE* f, uint32_t* out) {
+    unsigned char b[4];
+    if (fread(b, 1, 4, f) != 4) return 0;
+    *out = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    return 1;
+}
+
+static int read_f64(FILE* f, double* out) {
+    unsigned char b[8];
+    if (fread(b, 1, 8, f) != 8) return 0;
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; i--) {
+        bits = (bits << 8) | b[i];
+    }
+    memcpy(out, &bits, sizeof(*out));
+    return 1;
+}
+
+static void free_network(NeatNetwork* net) {
+    free(net->evals);
+    free(net->link_inputs);
+    free(net->link_weights);
+    free(net->values);
+    memset(net, 0, sizeof(*net));
+}
+
+static int load_network(NeatNetwork* net, const char* path) {
+    memset(net, 0, sizeof(*net));
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "neat_native: cannot open genome %s\n", path);
+        return 0;
+    }
+
+    char magic[4];
+    uint32_t version, num_inputs, num_outputs;
+    int ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, "NEAT", 4) == 0
+        && read_u32(f, &version) && version == GENOME_VERSION
+        && read_u32(f, &num_inputs) && num_inputs == NEAT_NUM_INPUTS
+        && read_u32(f, &num_outputs) && num_outputs == NEAT_NUM_OUTPUTS
+        && read_u32(f, &net->num_nodes) && net->num_nodes >= num_inputs + num_outputs
+        && read_u32(f, &net->num_evals);
+
+    uint32_t link_capacity = 0;
+    uint32_t num_links = 0;
+    if (ok) {
+        net->evals = calloc(net->num_evals ? net->num_evals : 1, sizeof(NodeEval));
+        net->values = calloc(net->num_nodes, sizeof(double));
+        ok = net->evals && net->values;
+    }
+    for (uint32_t i = 0; ok && i < net->num_evals; i++) {
+        NodeEval* eval = &net->evals[i];
+        unsigned char kinds[4];
+        ok = read_u32(f, &eval->node) && eval->node < net->num_nodes
+            && fread(kinds, 1, 4, f) == 4
+            && read_f64(f, &eval->bias)
+            && read_f64(f, &eval->response)
+            && read_u32(f, &eval->num_links);
+        if (!ok) break;
+        eval->activation = kinds[0];
+        eval->aggregation = kinds[1];
+        ok = eval->activation <= ACT_CUBE && eval->aggregation <= AGG_MEAN;
+        eval->first_link = num_links;
+
+        for (uint32_t j = 0; ok && j < eval->num_links; j++) {
+            if (num_links == link_capacity) {
+                link_capacity = link_capacity ? link_capacity * 2 : 256;
+                uint32_t* inputs = realloc(net->link_inputs, link_capacity * sizeof(uint32_t));
+                if (inputs) net->link_inputs = inputs;
+                double* weights = realloc(net->link_weights, link_capacity * sizeof(double));
+                if (weights) net->link_weights = weights;
+                ok = inputs && weights;
+                if (!ok) break;
+            }
+            ok = read_u32(f, &net->link_inputs[num_links]) && net->link_inputs[num_links] < net->num_nodes
+                && read_f64(f, &net->link_weights[num_links]);
+            num_links++;
+        }
+    }
+    fclose(f);
+
+    if (!ok) {
+        fprintf(stderr, "neat_native: malformed genome %s\n", path);
+        free_network(net);
+    }
+    return ok;
+}
+
+// Activation functions as defined by neat-python
+static double activate_node(uint8_t activation, double z) {
+    switch (activation) {
+    case ACT_SIGMOID:
+        z = fmax(-60.0, fmin(60.0, 5.0 * z));
+        return 1.0 / (1.0 + exp(-z));
+    case ACT_TANH:
+        z = fmax(-60.0, fmin(60.0, 2.5 * z));
+        return tanh(z);
+    case ACT_RELU:
+        return z > 0.0 ? z : 0.0;
+    case ACT_IDENTITY:
+        return z;
+    case ACT_CLAMPED:
+        return fmax(-1.0, fmin(1.0, z));
+    case ACT_SIN:
+        z = fmax(-60.0, fmin(60.0, 5.0 * z));
+        return sin(z);
+    case ACT_GAUSS:
+        z = fmax(-3.4, fmin(3.4, z));
+        return exp(-5.0 * pow(z, 2.0));
+    case ACT_ABS:
+        return fabs(z);
+    case ACT_SQUARE:
+        return pow(z, 2.0);
+    case ACT_CUBE:
+        return pow(z, 3.0);
+    }
+    return z;
+}
+
+// Same arithmetic order as FeedForwardNetwork.activate, so outputs match bit for bit
+static const double* activate_network(NeatNetwork* net, const float* inputs) {
+    double* values = net->values;
+    for (uint32_t i = 0; i < NEAT_NUM_INPUTS; i++) {
+        values[i] = inputs[i];
+    }
+
+    for (uint32_t i = 0; i < net->num_evals; i++) {
+        const NodeEval* eval = &net->evals[i];
+        const uint32_t* link_inputs = net->link_inputs + eval->first_link;
+        const double* link_weights = net->link_weights + eval->first_link;
+
+        double s = 0.0;
+        switch (eval->aggregation) {
+        case AGG_SUM:
+        case AGG_MEAN:
+            for (uint32_t j = 0; j < eval->num_links; j++) {
+                s += values[link_inputs[j]] * link_weights[j];
+            }
+            if (eval->aggregation == AGG_MEAN && eval->num_links) {
+                s /= eval->num_links;
+            }
+            break;
+        case AGG_PRODUCT:
+            s = 1.0;
+            for (uint32_t j = 0; j < eval->num_links; j++) {
+                s *= values[link_inputs[j]] * link_weights[j];
+            }
+            break;
+        case AGG_MAX:
+        case AGG_MIN:
+        case AGG_MAXABS:
+            for (uint32_t j = 0; j < eval->num_links; j++) {
+                double v = values[link_inputs[j]] * link_weights[j];
+                if (j == 0
+                    || (eval->aggregation == AGG_MAX && v > s)
+                    || (eval->aggregation == AGG_MIN && v < s)
+                    || (eval->aggregation == AGG_MAXABS && fabs(v) > fabs(s))) {
+                    s = v;
+                }
+            }
+            break;
+        }
+        values[eval->node] = activate_node(eval->activation, eval->bias + eval->response * s);
+    }
+    return values + NEAT_NUM_INPUTS;
+}
+
+static const double* evaluate(NEATNativeAgent* agent, const GameStateView* state, NeatDecision decision, const TradeOffer* offer) {
+    float features[NEAT_NUM_INPUTS];
+    if (!neat_extract_features(state, agent->agent_index, decision, offer, features)) {
+        return NULL;
+    }
+    return activate_network(&agent->net, features);
+}
+
+int abi_version() {
+    return ABI_VERSION;
+}
+
+void* create_agent(const char* config_json) {
+    char genome_path[1024];
+    if (!config_string(config_json, "genome_path", genome_path, sizeof(genome_path))) {
+        fprintf(stderr, "neat_native: config needs \"genome_path\" to an exported genome\n");
+        return NULL;
+    }
+
+    NEATNativeAgent* agent = malloc(sizeof(NEATNativeAgent));
+    if (!agent) {
+        return NULL;
+    }
+    if (!load_network(&agent->net, genome_path)) {
+        free(agent);
+        return NULL;
+    }
+
+    agent->agent_index = 0;
+    agent->seed = 0;
+    strncpy(agent->name, "NEATNative", sizeof(agent->name) - 1);
+    agent->name[sizeof(agent->name) - 1] = '\0';
+    return agent;
+}
+
+void destroy_agent(void* agent_ptr) {
+    if (agent_ptr) {
+        NEATNativeAgent* agent = (NEATNativeAgent*)agent_ptr;
+        free_network(&agent->net);
+        free(agent);
+    }
+}
+
+void game_start(void* agent_ptr, uint32_t agent_index, uint64_t seed) {
+    NEATNativeAgent* agent = (NEATNativeAgent*)agent_ptr;
+    if (!agent) return;
+
+    agent->agent_index = agent_index;
+    agent->seed = seed;
+}
+
+Action agent_turn(void* agent_ptr, const GameStateView* state) {
+    NEATNativeAgent* agent = (NEATNativeAgent*)agent_ptr;
+    Action action = {0};
+    action.type = ACTION_END_TURN;
+
+    if (!agent || !state) return action;
+    const double* output = evaluate(agent, state, NEAT_DECISION_TURN, NULL);
+    if (!output) return action;
+
+    // output[2..9] are the action scores, first highest wins
+    int best_action = 0;
+    for (int i = 1; i < 8; i++) {
+        if (output[2 + i] > output[2 + best_action]) best_action = i;
+    }
+
+    switch (best_action) {
+    case 2:
+        action.type = ACTION_LANDED_PROPERTY;
+        action.buying_property = output[0] > 0.5;
+        break;
+    case 3:
+        action.type = ACTION_USE_JAIL_CARD;
+        break;
+    case 4:
+        action.type = ACTION_PAY_JAIL_FINE;
+        break;
+    case 5:
+        action.type = ACTION_JAIL_ROLL_DOUBLE;
+        break;
+    case 6:
+        // Property choice is not passed through by neat_bridge either
+        action.type = ACTION_DEVELOP;
+        action.property_position = 0;
+        break;
+    case 7: {
+        // Propose a trade when a high scoring property is ours and another belongs to an opponent
+        bool ours = false, theirs = false;
+        for (uint32_t i = 0; i < 28 && i < state->num_properties; i++) {
+            const PropertyView* prop = &state->properties[i];
+            if (output[10 + i] <= 0.75 || !prop->is_owned) continue;
+            if (prop->owner_index == agent->agent_index) ours = true;
+            else theirs = true;
+        }
+        if (ours && theirs) {
+            action.type = ACTION_TRADE;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return action;
+}
+
+Action auction(void* agent_ptr, const GameStateView* state, const AuctionView* auction) {
+    NEATNativeAgent* agent = (NEATNativeAgent*)agent_ptr;
+    Action action = {0};
+    action.type = ACTION_END_TURN;
+
+    if (!agent || !state || !auction) return action;
+    if (agent->agent_index >= state->players_remaining) return action;
+    const PlayerView* agent_player = &state->players[agent->agent_index];
+
+    const PropertyView* prop = NULL;
+    for (uint32_t i = 0; i < state->num_properties; i++) {
+        if (state->properties[i].property_id == auction->property_id) {
+            prop = &state->properties[i];
+            break;
+        }
+    }
+    if (!prop) return action;
+
+    const double* output = evaluate(agent, state, NEAT_DECISION_AUCTION, NULL);
+    if (!output) return action;
+
+    double bid_multiplier = output[1];
+    double max_bid = trunc(prop->purchase_price * bid_multiplier * 0.8);
+    double cash_limit = trunc(agent_player->cash * 0.3);
+    double bid = max_bid < cash_limit ? max_bid : cash_limit;
+    if (bid >= 10 && bid_multiplier > 0.3) {
+        action.type = ACTION_AUCTION_BID;
+        action.auction_bid = (uint32_t)bid;
+    }
+    return action;
+}
+
+Action trade_offer(void* agent_ptr, const GameStateView* state, const TradeOffer* offer) {
+    NEATNativeAgent* agent = (NEATNativeAgent*)agent_ptr;
+    Action action = {0};
+    action.type = ACTION_TRADE_RESPONSE;
+    action.trade_response = false;
+
+    if (!agent || !state || !offer) return action;
+    const double* output = evaluate(agent, state, NEAT_DECISION_TRADE, offer);
+    if (!output) return action;
+
+    action.trade_response = output[0] > 0.75;
+    return action;
+}
+
+AgentVTable vtable = {
+    .abi_version = abi_version,
+    .create_agent = create_agent,
+    .destroy_agent = destroy_agent,
+    .game_start = game_start,
+    .agent_turn = agent_turn,
+    .auction = auction,
+    .trade_offer = trade_offer,
+    .flags = AGENT_FLAG_THREAD_SAFE
+};
+
+AGENT_API AgentExport create_agent_export(const char* config_json) {
+    AgentExport export;
+    export.vtable = vtable;
+    return export;
+}
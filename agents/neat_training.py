@@ -9,29 +9,48 @@ import multiprocessing as mp
 import _socket
 from typing import Dict, List, Tuple
 import os
+import sys
+from engine_client import EngineClient
+from export_genome import export_genome
 
 
 ENGINE_PATH = "./build/Release/monopoly_engine.exe"
 NEAT_AGENT_PATH = "./build/agents/Release/neat_bridge.dll"
+# Pure C evaluator, takes genomes written by export_genome.py
+NEAT_NATIVE_AGENT_PATH = "./build/agents/Release/neat_native.dll"
 OPPONENT_AGENTS = [
     "./build/agents/Release/neat_bridge.dll",
     "./build/agents/Release/neat_bridge.dll",
     "./build/agents/Release/neat_bridge.dll",
 ]
+# Worker threads per engine process, 0 = one per core
+ENGINE_THREADS = 0
+# Directory holding the `monopoly` extension module; if it imports, games run in this process
+ENGINE_MODULE_DIR = "./build/Release"
 NAIVE_OPPONENT_AGENTS = [
     "./build/agents/Release/greedy_agent.dll",
     "./build/agents/Release/random_agent.dll",
     "./build/agents/Release/greedy_agent.dll",
     ]
 
+sys.path.insert(0, ENGINE_MODULE_DIR)
+try:
+    import monopoly
+except ImportError:
+    monopoly = None
+
 # Written with the assistance of Copilot
 class NeatTraining:
-    def __init__(self, config_path='agents/neat_config.txt' , num_opponents: int = 2, num_games: int = 50):
+    def __init__(self, config_path='agents/neat_config.txt' , num_opponents: int = 2, num_games: int = 50, engine_socket: str = None):
         self.config_path = config_path
         self.num_opponents = num_opponents
         self.num_games = num_games
         self.generation = 0
         self.game_counter = 0
+        # Talk to a running `monopoly_engine --serve` instead of spawning engine processes
+        self.engine_client = EngineClient(engine_socket) if engine_socket else None
+        # Otherwise prefer the in-process engine over spawning monopoly_engine
+        self.engine = monopoly.Engine(ENGINE_THREADS) if monopoly and not engine_socket else None
 
         self.config = neat.Config(
             neat.DefaultGenome,
@@ -42,7 +61,7 @@ class NeatTraining:
         )
         self.population = neat.Population(self.config)
 
-    def create_game_config(self, genome_path: str, game_id: int, test: bool = False) -> Dict:
+    def create_game_config(self, genome_path: str, game_id: int, test: bool = False, native: bool = False) -> Dict:
         # Neat agent config
         neat_config = {
             'genome_path': genome_path,
@@ -51,7 +70,7 @@ class NeatTraining:
 
         # agent specs
         agents = [{
-            'path': NEAT_AGENT_PATH,
+            'path': NEAT_NATIVE_AGENT_PATH if native else NEAT_AGENT_PATH,
             'config': neat_config,
             'name': 'NEATAgent'
         }]
@@ -244,6 +263,71 @@ class NeatTraining:
                 if os.path.exists(f):
                     os.remove(f)
     
+    def run_batch(self, configs: List[Dict]) -> List[Tuple[int, Dict]]:
+        failed = [(-1, {'winner': -1, 'game_id': config['game_id']}) for config in configs]
+        if self.engine_client:
+            try:
+                lines = [json.dumps(game_result) for game_result in self.engine_client.run_games(configs)]
+            except Exception as e:
+                print(f"Engine server request failed: {e}")
+                return failed
+            return self.parse_results(lines, configs, failed)
+        if self.engine:
+            try:
+                results = self.engine.run_games(configs)
+            except Exception as e:
+                print(f"Batch of {len(configs)} games encountered an error: {e}")
+                return failed
+            return self.collect_outcomes([{
+                'game_id': r.game_id,
+                'winner': r.winner,
+                'penalties': r.penalties,
+                'player_scores': r.player_scores,
+                **({'error': r.error} if r.error else {}),
+            } for r in results], configs, failed)
+
+        # Run every game in one engine process, agents are loaded once for the whole batch
+        manifest = ''.join(json.dumps(config) + '\n' for config in configs)
+        try:
+            result = subprocess.run(
+                [ENGINE_PATH, '--batch', '-', '--threads', str(ENGINE_THREADS)],
+                input=manifest,
+                capture_output=True,
+                text=True,
+                timeout=60 * max(len(configs), 1),
+            )
+        except subprocess.TimeoutExpired:
+            print(f"Batch of {len(configs)} games timed out.")
+            return failed
+        except Exception as e:
+            print(f"Batch of {len(configs)} games encountered an error: {e}")
+            return failed
+
+        if result.returncode != 0:
+            print(f"Batch failed with error: {result.stderr}")
+            return failed
+        return self.parse_results(result.stdout.splitlines(), configs, failed)
+
+    def parse_results(self, lines: List[str], configs: List[Dict], failed: List[Tuple[int, Dict]]) -> List[Tuple[int, Dict]]:
+        # One NDJSON result per game, in manifest order
+        return self.collect_outcomes([json.loads(line) for line in lines if line.startswith('{')], configs, failed)
+
+    def collect_outcomes(self, game_results: List[Dict], configs: List[Dict], failed: List[Tuple[int, Dict]]) -> List[Tuple[int, Dict]]:
+        outcomes = []
+        for game_result in game_results:
+            if 'error' in game_result:
+                print(f"Game {game_result.get('game_id')} failed with error: {game_result['error']}")
+                outcomes.append((-1, {'winner': -1, 'game_id': game_result.get('game_id')}))
+                continue
+            winner = game_result.get('winner', -1)
+            outcomes.append((winner, {
+                'winner': winner,
+                'game_id': game_result.get('game_id'),
+                'penalties': game_result.get('penalties', {}),
+                'player_scores': game_result.get('player_scores', []),
+            }))
+        return outcomes if len(outcomes) == len(configs) else failed
+
     def evaluate_tournament_match(self, genomes: List[Tuple[int, object]]) -> Dict[int, float]:
         # Save genomes to temp file
         genome_paths = {}
@@ -266,14 +350,14 @@ class NeatTraining:
         }
         
         try:
-            # Play tournament
+            # Play tournament, all games of the match in one engine process
+            paths = [genome_paths[gid] for gid, _ in genomes]
+            configs = []
             for i in range(self.num_games):
-                game_id = self.game_counter
+                configs.append(self.create_tournament_config(paths, self.game_counter))
                 self.game_counter += 1
-                
-                paths = [genome_paths[gid] for gid, _ in genomes]
-                winner, stats = self.run_tournament_game(paths, game_id)
 
+            for winner, stats in self.run_batch(configs):
                 for index, (gid, _) in enumerate(genomes):
                     genome_stats[gid]['games'] += 1
                     if index == winner:
@@ -425,7 +509,7 @@ class NeatTraining:
 
         return best_genome, stats
     
-    def test_genome(genome_path= None, num_games: int = 20, checkpoint: str = None):
+    def test_genome(genome_path= None, num_games: int = 20, checkpoint: str = None, engine_socket: str = None, native: bool = False):
         temp_f = False
         if checkpoint:
             print(f"Restoring from checkpoint {checkpoint} to test best genome...")
@@ -439,12 +523,18 @@ class NeatTraining:
         else:
             print(f"Testing genome from {genome_path}...")
 
-        trainer = NeatTraining(num_opponents=3, num_games=num_games)
+        trainer = NeatTraining(num_opponents=3, num_games=num_games, engine_socket=engine_socket)
+        if native:
+            # Evaluate with neat_native, no Python in the game loop
+            with open(genome_path, 'rb') as f:
+                genome = pickle.load(f)
+            export_genome(genome, trainer.config, 'temp_best_genome.bin')
+            genome_path = 'temp_best_genome.bin'
         wins = 0
         total_agent_score = 0
         total_opponent_score = 0
-        for i in range(num_games):
-            winner, stats = trainer.run_game(genome_path, i, test=True)
+        configs = [trainer.create_game_config(genome_path, i, test=True, native=native) for i in range(num_games)]
+        for winner, stats in trainer.run_batch(configs):
             if winner == 0:
                 wins += 1
             scores = stats.get('player_scores', [])
@@ -465,6 +555,8 @@ class NeatTraining:
         if temp_f == True:
             if os.path.exists('temp_best_genome.pkl'):
                 os.remove('temp_best_genome.pkl')
+        if native and os.path.exists('temp_best_genome.bin'):
+            os.remove('temp_best_genome.bin')
     
                 
 
@@ -477,15 +569,17 @@ def main():
     parser.add_argument('--num_games', type=int, default=20, help='Number of games per genome evaluation')
     parser.add_argument('--checkpoint', type=str, default=None, help='Path to checkpoint file')
     parser.add_argument('--genome', type=str, default='genomes/best_genome.pkl', help='Path to genome file for testing')
+    parser.add_argument('--engine_socket', type=str, default=None, help='Socket of a running `monopoly_engine --serve`')
+    parser.add_argument('--native', action='store_true', help='Test with the native C evaluator (neat_native) instead of the Python bridge')
     args = parser.parse_args()
 
     if args.train:
         # Train NEAT agent (parallel for faster training)
-        trainer = NeatTraining(num_opponents=args.opponents, num_games=args.num_games)
+        trainer = NeatTraining(num_opponents=args.opponents, num_games=args.num_games, engine_socket=args.engine_socket)
         trainer.train(generations=args.generations, checkpoint=args.checkpoint)
     elif args.test:
         # Test against naive opponents
-        NeatTraining.test_genome(genome_path=args.genome, num_games=args.num_games, checkpoint=args.checkpoint)
+        NeatTraining.test_genome(genome_path=args.genome, num_games=args.num_games, checkpoint=args.checkpoint, engine_socket=args.engine_socket, native=args.native)
     else:
         print("Use --train to train or --test to test an agent")
         print(f"Example: python {__file__} --train --generations 30 --num_games 5")
@@ -177,7 +177,8 @@ AgentVTable vtable = {
     .game_start = game_start,
     .agent_turn = agent_turn,
     .auction = auction,
-    .trade_offer = trade_offer
+    .trade_offer = trade_offer,
+    .flags = AGENT_FLAG_THREAD_SAFE
 };
 
 AGENT_API AgentExport create_agent_export(const char* config_json) {
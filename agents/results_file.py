@@ -0,0 +1,51 @@
+import struct
+
+import numpy as np
+
+# Reader for monopoly_engine --batch ... --results files, layout in src/engine/results_file.h.
+# Rows are memory-mapped, so columns like rows['winner'] or rows['scores'][:, 0] load lazily.
+RESULTS_MAGIC = b'MRES'
+RESULTS_VERSION = 1
+HEADER_SIZE = 64
+FLAG_FINAL_STATE = 0x1
+
+
+def results_dtype(max_players: int = 8, num_properties: int = 28, final_state: bool = False) -> np.dtype:
+    fields = [
+        ('game_id', '<u8'),
+        ('seed', '<u8'),
+        ('turns', '<u4'),
+        ('winner', '<i4'),
+        ('num_players', 'u1'),
+        ('ok', 'u1'),
+        ('_pad', 'V6'),
+        ('scores', '<f8', (max_players,)),
+        ('penalties', '<f8', (max_players,)),
+    ]
+    if final_state:
+        fields += [
+            ('cash', '<u4', (max_players,)),
+            ('position', 'u1', (max_players,)),
+            ('player_flags', 'u1', (max_players,)),  # 1 retired, 2 in jail
+            ('jail_free_cards', 'u1', (max_players,)),
+            ('owner', 'i1', (num_properties,)),  # -1 unowned
+            ('houses', 'u1', (num_properties,)),
+            ('property_flags', 'u1', (num_properties,)),  # 1 mortgaged, 2 hotel
+            ('_pad_state', 'V4'),
+        ]
+    return np.dtype(fields)
+
+
+def load_results(path: str, mode: str = 'r') -> np.memmap:
+    with open(path, 'rb') as f:
+        header = f.read(HEADER_SIZE)
+    if len(header) < HEADER_SIZE or header[:4] != RESULTS_MAGIC:
+        raise ValueError(f"{path} is not a results file")
+    version, row_size, max_players, num_properties, flags = struct.unpack_from('<IIIII', header, 4)
+    if version != RESULTS_VERSION:
+        raise ValueError(f"Unsupported results file version {version}")
+
+    dtype = results_dtype(max_players, num_properties, bool(flags & FLAG_FINAL_STATE))
+    if dtype.itemsize != row_size:
+        raise ValueError(f"Row size {row_size} does not match the expected layout ({dtype.itemsize})")
+    return np.memmap(path, dtype=dtype, mode=mode, offset=HEADER_SIZE)
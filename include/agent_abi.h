@@ -15,7 +15,7 @@
 extern "C" {
 #endif
 
-#define ABI_VERSION 1
+#define ABI_VERSION 2
 
 typedef enum {
     ACTION_LANDED_PROPERTY,
@@ -43,6 +43,11 @@ typedef struct {
     };
 } Action;
 
+// Threading contract a plugin declares through AgentVTable.flags.
+// With neither flag set every game using the plugin is serialised process-wide.
+#define AGENT_FLAG_THREAD_SAFE     0x1u // instances may be created/used/destroyed on any thread, one caller per instance at a time
+#define AGENT_FLAG_THREAD_CONFINED 0x2u // instances are independent but each must stay on the thread that created it
+
 typedef struct AgentVTable {
     int (*abi_version)(); // Check agent has same headerfile
 
@@ -56,6 +61,8 @@ typedef struct AgentVTable {
     Action (*auction)(void* agent, const GameStateView* state, const AuctionView* auction);
     // Trade offer proposed elsewhere to this agent
     Action (*trade_offer)(void* agent, const GameStateView* state, const TradeOffer* offer);
+
+    uint32_t flags; // AGENT_FLAG_*
 } AgentVTable;
 
 typedef struct {
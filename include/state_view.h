@@ -46,6 +46,7 @@ typedef struct {
 typedef struct {
     uint32_t property_id;
     uint32_t current_bid;
+    bool proxy; // asked once per auction: bid the most you would pay, the engine sets the price
 } AuctionView;
 
 // State for each player
@@ -0,0 +1,401 @@
+#include "engine.h"
+#include "agent_pool.h"
+#include "game_runner.h"
+#include "result_json.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Engine hot paths on fixed synthetic states, then whole games with the random and greedy agents.
+// Prints one JSON object per benchmark line, so runs before and after a change can be diffed.
+// Micro benchmarks that change the state restore it before every call; their ns_per_op has the
+// restore (reset_ns, measured by state_reset) taken out.
+
+#ifndef BENCH_AGENT_DIR
+#define BENCH_AGENT_DIR "agents"
+#endif
+#ifndef RANDOM_AGENT_FILE
+#define RANDOM_AGENT_FILE "librandom_agent.so"
+#endif
+#ifndef GREEDY_AGENT_FILE
+#define GREEDY_AGENT_FILE "libgreedy_agent.so"
+#endif
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Fixed answers, so every run of a benchmark makes the same decisions
+class BenchPolicy : public Policy {
+public:
+    Action agent_turn(const GameState&, uint32_t) override {
+        Action action = {};
+        action.type = ACTION_END_TURN;
+        return action;
+    }
+
+    Action auction(const GameState& state, uint32_t player_index, const AuctionView& auction) override {
+        static constexpr uint32_t RESERVE = 100;
+        const PlayerView& player = state.players[player_index];
+        const PropertyView& property = state.properties[auction.property_id];
+        const uint32_t limit = std::min<uint32_t>(property.purchase_price, player.cash > RESERVE ? player.cash - RESERVE : 0);
+        Action bid = {};
+        bid.type = ACTION_AUCTION_BID;
+        bid.auction_bid = limit > auction.current_bid ? limit : 0;
+        return bid;
+    }
+
+    Action trade_offer(const GameState&, uint32_t, const TradeOffer&) override {
+        Action response = {};
+        response.type = ACTION_TRADE_RESPONSE;
+        response.trade_response = false;
+        return response;
+    }
+};
+}
+
+// Reaches the private rules of one Engine, friend of Engine
+class EngineBench {
+public:
+    explicit EngineBench(const GameState& state) : engine_(state, policy_) {}
+
+    GameState& state() { return engine_.state_; };
+    PlayerView& player(uint32_t index) { return engine_.state_.players[index]; };
+    void reset(const GameState& state) { engine_.state_ = state; };
+
+    RollResult dice_roll() { return engine_.dice_roll(); };
+    void handle_position(uint32_t index) { engine_.handle_position(this->player(index)); };
+    bool raise_fund(uint32_t index, uint32_t owed) { return engine_.raise_fund(this->player(index), owed); };
+    void pay_by_mortgage(uint32_t index, uint32_t assets, uint32_t amount) {
+        engine_.pay_by_mortgage(this->player(index), assets, amount);
+    };
+    void pay_by_houses(uint32_t index, uint32_t assets, uint32_t amount) {
+        engine_.pay_by_houses(this->player(index), assets, amount);
+    };
+    void auction(uint32_t property) { engine_.auction(property); };
+    void update_rent(uint32_t property) { engine_.update_rent(property); };
+    void community_card_draw(uint32_t index) { engine_.community_card_draw(this->player(index)); };
+    bool chance_card_draw(uint32_t index) { return engine_.chance_card_draw(this->player(index)); };
+    void buy_property(uint32_t index, uint32_t property) { engine_.buy_property(this->player(index), property); };
+    void build_house(uint32_t index, uint32_t property) { engine_.build_house(this->player(index), property); };
+    void mortgage(uint32_t index, uint32_t property) { engine_.mortgage(this->player(index), property); };
+
+private:
+    BenchPolicy policy_;
+    Engine engine_;
+};
+
+namespace {
+struct Options {
+    std::string filter; // run benchmarks whose name contains this
+    double min_seconds = 0.2; // per micro benchmark
+    uint64_t games = 200; // per end-to-end lineup
+    uint32_t max_turns = 1000;
+    unsigned int threads = 1;
+    std::string agent_dir = BENCH_AGENT_DIR;
+};
+
+// Results of benchmarked calls end up here, so they are not optimised out
+volatile uint64_t sink = 0;
+
+void keep(uint64_t value) {
+    sink = sink + value;
+}
+
+void emit(std::string& line) {
+    line.push_back('\n');
+    std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+    std::cout.flush();
+    line.clear();
+}
+
+// Calls op(i) in growing batches until one batch takes min_seconds, returns ns per call
+double time_op(const std::function<void(uint64_t)>& op, double min_seconds, uint64_t& iterations) {
+    for (uint64_t batch = 16;; batch *= 2) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < batch; i++) {
+            op(i);
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= min_seconds || batch >= (1ull << 40)) {
+            iterations = batch;
+            return seconds * 1e9 / static_cast<double>(batch);
+        }
+    }
+}
+
+// Four players some 60 rounds in: monopolies with houses and hotels, all railroads and utilities
+// in one hand, a few loose and mortgaged streets, and little cash to go round.
+GameState midgame_state() {
+    const Board& b = board();
+    EngineBench bench(GameState::initial(42, 4, 1000));
+    for (uint32_t index = 0; index < 4; index++) {
+        bench.player(index).cash = 10000;
+    }
+
+    auto buy_colour = [&](uint32_t index, Colour colour) {
+        for (uint32_t bits = b.colourMask(colour); bits; bits &= bits - 1) {
+            bench.buy_property(index, std::countr_zero(bits));
+        }
+    };
+    // Evenly, like the rules require
+    auto build = [&](uint32_t index, Colour colour, uint8_t houses) {
+        for (uint8_t level = 0; level < houses; level++) {
+            for (uint32_t bits = b.colourMask(colour); bits; bits &= bits - 1) {
+                bench.build_house(index, std::countr_zero(bits));
+            }
+        }
+    };
+
+    buy_colour(0, Colour::Brown);
+    buy_colour(0, Colour::Blue);
+    build(0, Colour::Brown, 2);
+    build(0, Colour::Blue, 4);
+
+    for (uint32_t bits = b.railroad_mask | b.utility_mask; bits; bits &= bits - 1) {
+        bench.buy_property(1, std::countr_zero(bits));
+    }
+    bench.mortgage(1, std::countr_zero(b.utility_mask));
+
+    buy_colour(2, Colour::Orange);
+    buy_colour(2, Colour::Red);
+    build(2, Colour::Orange, GameState::HOTEL);
+    build(2, Colour::Red, 3);
+
+    const uint32_t yellow = b.colourMask(Colour::Yellow);
+    const uint32_t green = b.colourMask(Colour::Green);
+    const uint32_t navy = b.colourMask(Colour::Navy);
+    for (uint32_t index : {std::countr_zero(yellow), std::countr_zero(yellow & (yellow - 1)), std::countr_zero(green),
+                           std::countr_zero(navy)}) {
+        bench.buy_property(3, index);
+    }
+    bench.mortgage(3, std::countr_zero(green));
+
+    const std::array<uint32_t, 4> cash = {60, 350, 120, 240};
+    const std::array<uint8_t, 4> position = {9, 25, 19, 37};
+    for (uint32_t index = 0; index < 4; index++) {
+        bench.player(index).cash = cash[index];
+        bench.player(index).position = position[index];
+    }
+    bench.state().turn = 60;
+    bench.state().sync_properties();
+    return bench.state();
+}
+
+struct Micro {
+    std::string_view name;
+    bool resets; // restores the state before every call
+    std::function<void(EngineBench&, const GameState&, uint64_t)> op;
+};
+
+std::vector<Micro> micro_benchmarks() {
+    const Board& b = board();
+    const uint32_t unowned_pink = std::countr_zero(b.colourMask(Colour::Pink));
+    return {
+        {"state_reset", true, [](EngineBench&, const GameState&, uint64_t) {}},
+        {"dice_roll", false, [](EngineBench& bench, const GameState&, uint64_t) {
+             keep(bench.dice_roll().total());
+         }},
+        // Every tile in turn, by the player with the most to pay with
+        {"handle_position", true, [](EngineBench& bench, const GameState&, uint64_t i) {
+             bench.player(1).position = static_cast<uint8_t>(i % 40);
+             bench.handle_position(1);
+             keep(bench.player(1).cash);
+         }},
+        // Mortgages, then sells houses and hotels
+        {"raise_fund", true, [](EngineBench& bench, const GameState&, uint64_t) {
+             keep(bench.raise_fund(2, 1500));
+         }},
+        {"pay_by_mortgage", true, [](EngineBench& bench, const GameState& base, uint64_t) {
+             const uint32_t assets = base.owned_by(1) & ~base.mortgaged_mask;
+             bench.pay_by_mortgage(1, assets, 900);
+             keep(bench.player(1).cash);
+         }},
+        {"pay_by_houses", true, [](EngineBench& bench, const GameState& base, uint64_t) {
+             bench.pay_by_houses(2, base.developed_by(2), 1000);
+             keep(bench.player(2).cash);
+         }},
+        // Selling a hotel with too few houses in the bank to break it down
+        {"pay_by_houses_shortage", true, [](EngineBench& bench, const GameState& base, uint64_t) {
+             bench.state().houses_remaining = 2;
+             bench.pay_by_houses(2, base.developed_by(2), 1000);
+             keep(bench.player(2).cash);
+         }},
+        {"auction", true, [unowned_pink](EngineBench& bench, const GameState&, uint64_t) {
+             bench.auction(unowned_pink);
+             keep(bench.state().owner[unowned_pink]);
+         }},
+        {"update_rent", false, [](EngineBench& bench, const GameState&, uint64_t i) {
+             bench.update_rent(static_cast<uint32_t>(i % GameState::NUM_PROPERTIES));
+             keep(bench.state().rent[i % GameState::NUM_PROPERTIES]);
+         }},
+        // Each card of the deck in turn, from Community Chest / Chance tiles
+        {"community_card_draw", true, [](EngineBench& bench, const GameState&, uint64_t i) {
+             CardDeck& deck = bench.state().community_deck;
+             deck.head = static_cast<uint32_t>(i % deck.count);
+             bench.player(1).position = 2;
+             bench.community_card_draw(1);
+             keep(bench.player(1).cash);
+         }},
+        {"chance_card_draw", true, [](EngineBench& bench, const GameState&, uint64_t i) {
+             CardDeck& deck = bench.state().chance_deck;
+             deck.head = static_cast<uint32_t>(i % deck.count);
+             bench.player(1).position = 7;
+             keep(bench.chance_card_draw(1) + bench.player(1).cash);
+         }},
+    };
+}
+
+void run_micro(const Options& options, std::string& line) {
+    const GameState base = midgame_state();
+    EngineBench bench(base);
+    JsonWriter out(line);
+    double reset_ns = 0;
+    for (const Micro& micro : micro_benchmarks()) {
+        const std::string name = "micro/" + std::string(micro.name);
+        if (name.find(options.filter) == std::string::npos && micro.name != "state_reset") {
+            continue;
+        }
+        bench.reset(base);
+        uint64_t iterations = 0;
+        double ns = time_op([&](uint64_t i) {
+            if (micro.resets) {
+                bench.reset(base);
+            }
+            micro.op(bench, base, i);
+        }, options.min_seconds, iterations);
+
+        if (micro.name == "state_reset") {
+            reset_ns = ns;
+            if (name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+        } else if (micro.resets) {
+            ns = std::max(0.0, ns - reset_ns);
+        }
+        out.raw("{\"name\":").string(name);
+        out.raw(",\"iterations\":").number(iterations);
+        out.raw(",\"ns_per_op\":").number(ns);
+        out.raw(",\"reset_ns\":").number(micro.resets && micro.name != "state_reset" ? reset_ns : 0.0);
+        out.raw('}');
+        emit(line);
+    }
+}
+
+struct Lineup {
+    std::string_view name;
+    std::vector<std::string_view> agents; // "random" or "greedy"
+};
+
+void run_games(const Options& options, std::string& line) {
+    const std::vector<Lineup> lineups = {
+        {"random_x4", {"random", "random", "random", "random"}},
+        {"greedy_x4", {"greedy", "greedy", "greedy", "greedy"}},
+        {"random_vs_greedy", {"random", "greedy", "random", "greedy"}},
+    };
+    AgentPool pool;
+    GameRunner runner(options.threads, &pool);
+    JsonWriter out(line);
+    for (const Lineup& lineup : lineups) {
+        const std::string name = "games/" + std::string(lineup.name);
+        if (name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        std::vector<GameConfig> configs;
+        for (uint64_t game = 0; game < options.games; game++) {
+            GameConfig config = {game, game, options.max_turns, {}};
+            for (std::string_view agent : lineup.agents) {
+                const char* file = agent == "random" ? RANDOM_AGENT_FILE : GREEDY_AGENT_FILE;
+                config.agent_specs.push_back({options.agent_dir + "/" + file, "{}", std::string(agent)});
+            }
+            configs.push_back(std::move(config));
+        }
+
+        // Loads the agent libraries into the pool before the clock starts
+        const std::vector<GameConfig> warmup(configs.begin(), configs.begin() + std::min<size_t>(configs.size(), runner.threads()));
+        runner.run(warmup);
+
+        const auto start = Clock::now();
+        const std::vector<GameRunner::Outcome> outcomes = runner.run(configs);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        uint64_t turns = 0;
+        uint64_t errors = 0;
+        std::string first_error;
+        for (const GameRunner::Outcome& outcome : outcomes) {
+            turns += outcome.result.turns;
+            if (!outcome.error.empty()) {
+                if (errors++ == 0) {
+                    first_error = outcome.error;
+                }
+            }
+        }
+        out.raw("{\"name\":").string(name);
+        out.raw(",\"games\":").number(static_cast<uint64_t>(outcomes.size()));
+        out.raw(",\"threads\":").number(runner.threads());
+        out.raw(",\"turns\":").number(turns);
+        out.raw(",\"seconds\":").number(seconds);
+        out.raw(",\"games_per_s\":").number(seconds > 0 ? outcomes.size() / seconds : 0.0);
+        out.raw(",\"turns_per_s\":").number(seconds > 0 ? turns / seconds : 0.0);
+        out.raw(",\"errors\":").number(errors);
+        if (errors > 0) {
+            out.raw(",\"error\":").string(first_error);
+        }
+        out.raw('}');
+        emit(line);
+    }
+}
+
+[[noreturn]] void usage(const char* prog) {
+    std::cerr << "Usage:\n"
+              << "  " << prog
+              << " [--filter <substring>] [--min_time <ms per micro benchmark>] [--games <n per lineup>]"
+                 " [--max_turns <t>] [--threads <n, 0 = all cores>] [--agents <dir>]\n"
+              << "    Benchmarks are named micro/<engine function> and games/<lineup>; one JSON line each\n";
+    std::exit(EXIT_FAILURE);
+}
+
+uint64_t parse_u64(const char* s, const char* what) {
+    try {
+        std::size_t idx = 0;
+        uint64_t val = std::stoull(s, &idx, 10);
+        if (s[idx] != '\0') throw std::invalid_argument("trailing chars");
+        return val;
+    } catch (...) {
+        std::cerr << "Invalid " << what << ": " << s << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min_time" && i + 1 < argc) {
+            options.min_seconds = static_cast<double>(parse_u64(argv[++i], "min_time")) / 1000;
+        } else if (arg == "--games" && i + 1 < argc) {
+            options.games = parse_u64(argv[++i], "games");
+        } else if (arg == "--max_turns" && i + 1 < argc) {
+            options.max_turns = static_cast<uint32_t>(parse_u64(argv[++i], "max_turns"));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<unsigned int>(parse_u64(argv[++i], "threads"));
+        } else if (arg == "--agents" && i + 1 < argc) {
+            options.agent_dir = argv[++i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    std::string line;
+    run_micro(options, line);
+    run_games(options, line);
+    return 0;
+}
@@ -1,27 +1,152 @@
 #include "agent_abi.h"
 #include "agent_adapter.h"
 #include "plugin_loader.h"
+#include "agent_call_thread.h"
+#include "game_stats.h"
+#include "log.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <stdexcept>
-#include <iostream>
+#include <vector>
+
+namespace {
+Action invoke(const AgentVTable& vtable, void* self, AgentCall call, const GameStateView* state,
+              const AuctionView* auction, const TradeOffer* offer) {
+    switch (call) {
+    case AgentCall::TURN: return vtable.agent_turn(self, state);
+    case AgentCall::AUCTION: return vtable.auction(self, state, auction);
+    case AgentCall::TRADE: return vtable.trade_offer(self, state, offer);
+    }
+    return {};
+}
+
+// What an agent that ran out of time does
+Action default_action(AgentCall call) {
+    Action action = {};
+    switch (call) {
+    case AgentCall::TURN:
+        action.type = ACTION_END_TURN;
+        break;
+    case AgentCall::AUCTION:
+        action.type = ACTION_AUCTION_BID;
+        action.auction_bid = 0;
+        break;
+    case AgentCall::TRADE:
+        action.type = ACTION_TRADE_RESPONSE;
+        action.trade_response = false;
+        break;
+    }
+    return action;
+}
+
+// Deep copy of a call's arguments for the call thread. A call that overruns keeps reading them
+// after the engine has moved on, or is gone.
+struct CallSnapshot {
+    GameStateView state;
+    std::vector<PlayerView> players;
+    std::vector<PropertyView> properties;
+    AuctionView auction = {};
+    TradeOffer offer = {};
+    std::deque<std::vector<uint32_t>> property_lists; // what the offers' TradeDetails point into
+
+    CallSnapshot(const GameStateView& view, const AuctionView* auction_view, const TradeOffer* trade_offer)
+        : state(view), players(view.players, view.players + view.players_remaining),
+          properties(view.properties, view.properties + view.num_properties) {
+        for (PlayerView& player : this->players) {
+            this->own(player.previous_offer);
+        }
+        this->state.players = this->players.data();
+        this->state.properties = this->properties.data();
+        if (auction_view) {
+            this->auction = *auction_view;
+        }
+        if (trade_offer) {
+            this->offer = *trade_offer;
+            this->own(this->offer);
+        }
+    }
+
+    void own(TradeOffer& trade) {
+        this->own(trade.offer_from);
+        this->own(trade.offer_to);
+    }
+
+    void own(TradeDetail& detail) {
+        if (!detail.properties) {
+            return;
+        }
+        this->property_lists.emplace_back(detail.properties, detail.properties + detail.property_num);
+        detail.properties = this->property_lists.back().data();
+    }
+};
+}
 
 AgentAdapter::AgentAdapter(const AgentSpec& spec) : name_ (spec.name) {
-    std::cerr << "AgentAdapter constructor\n";
-    std::cerr << "AgentAdapter LoadAgentLibrary\n";
+    LOG(DEBUG, "Loading agent ", spec.name, " from ", spec.path);
     handle_ = LoadAgentLibrary(spec.path);
-    std::cerr << "AgentAdaptoer make\n";
     export_ = handle_->make(spec.config_json);
-    std::cerr << "AgentAdapter self_\n";
     self_ = export_.vtable.create_agent(spec.config_json.c_str());
     if (!self_) {
         throw std::runtime_error("Agent create() returned null");
     }
-    std::cerr << "AgentAdapter constructed\n";
+    LOG(DEBUG, "Agent ", spec.name, " created");
 }
 
 AgentAdapter::~AgentAdapter() {
-    if (self_) {
-        export_.vtable.destroy_agent(self_);
+    this->destroy();
+}
+
+AgentAdapter::AgentAdapter(AgentAdapter&& other) noexcept
+    : name_(std::move(other.name_))
+    , export_(other.export_)      // assume this is trivially copyable / ok to copy
+    , self_(other.self_)
+    , handle_(std::move(other.handle_))
+    , latency_(std::move(other.latency_))
+    , budget_(other.budget_)
+    , spent_ns_(other.spent_ns_)
+    , overruns_(other.overruns_)
+    , overran_(other.overran_)
+    , call_thread_(std::move(other.call_thread_))
+{
+    other.self_ = nullptr;        // moved-from object won’t destroy the agent
+}
+
+AgentAdapter& AgentAdapter::operator=(AgentAdapter&& other) noexcept {
+    if (this != &other) {
+        // clean up current resource
+        this->destroy();
+
+        name_   = std::move(other.name_);
+        export_ = other.export_;
+        self_   = other.self_;
+        handle_ = std::move(other.handle_);
+        latency_ = std::move(other.latency_);
+        budget_ = other.budget_;
+        spent_ns_ = other.spent_ns_;
+        overruns_ = other.overruns_;
+        overran_ = other.overran_;
+        call_thread_ = std::move(other.call_thread_);
+
+        other.self_ = nullptr;
+    }
+    return *this;
+}
+
+void AgentAdapter::destroy() {
+    if (!self_) {
+        return;
+    }
+    const AgentVTable vtable = export_.vtable;
+    void* self = self_;
+    self_ = nullptr;
+    // The library stays loaded until the late call is out of it
+    if (call_thread_ && call_thread_->abandon([vtable, self, handle = handle_] { vtable.destroy_agent(self); })) {
+        call_thread_.reset();
+        return;
     }
+    call_thread_.reset();
+    vtable.destroy_agent(self);
 }
 
 void AgentAdapter::game_start(uint32_t agent_index, uint64_t seed) {
@@ -29,13 +154,103 @@ void AgentAdapter::game_start(uint32_t agent_index, uint64_t seed) {
 }
 
 Action AgentAdapter::agent_turn(const GameStateView* state) {
-    return export_.vtable.agent_turn(self_, state);
+    return this->timed(AgentCall::TURN, [&] { return this->decide(AgentCall::TURN, state, nullptr, nullptr); });
 }
 
 Action AgentAdapter::auction(const GameStateView* state, const AuctionView* auction) {
-    return export_.vtable.auction(self_, state, auction);
+    return this->timed(AgentCall::AUCTION, [&] { return this->decide(AgentCall::AUCTION, state, auction, nullptr); });
 }
 
 Action AgentAdapter::trade_offer(const GameStateView* state, const TradeOffer* offer) {
-    return export_.vtable.trade_offer(self_, state, offer);
+    return this->timed(AgentCall::TRADE, [&] { return this->decide(AgentCall::TRADE, state, nullptr, offer); });
+}
+
+void AgentAdapter::time_calls(bool on) {
+    if (!on) {
+        latency_.reset();
+        return;
+    }
+    latency_ = std::make_unique<AgentLatency>();
+    latency_->name = name_;
+}
+
+void AgentAdapter::set_budget(AgentBudget budget) {
+    budget_ = budget;
+    spent_ns_ = 0;
+    overruns_ = 0;
+    overran_ = false;
+    const bool threaded = (budget.call_ms || budget.game_ms) && (export_.vtable.flags & AGENT_FLAG_THREAD_SAFE);
+    if (threaded && !call_thread_) {
+        call_thread_ = std::make_unique<AgentCallThread>();
+    } else if (!threaded && call_thread_ && !call_thread_->stalled()) {
+        call_thread_.reset();
+    }
+}
+
+bool AgentAdapter::stalled() const {
+    return call_thread_ && call_thread_->stalled();
+}
+
+Action AgentAdapter::decide(AgentCall call, const GameStateView* state, const AuctionView* auction, const TradeOffer* offer) {
+    if (!budget_.call_ms && !budget_.game_ms) {
+        return invoke(export_.vtable, self_, call, state, auction, offer);
+    }
+
+    // Nanoseconds this call may take
+    uint64_t limit = UINT64_MAX;
+    if (budget_.call_ms) {
+        limit = uint64_t{budget_.call_ms} * 1000000;
+    }
+    if (budget_.game_ms) {
+        const uint64_t game_ns = uint64_t{budget_.game_ms} * 1000000;
+        limit = std::min(limit, game_ns - std::min(game_ns, spent_ns_));
+    }
+
+    overran_ = false;
+    std::optional<Action> action;
+    if (limit > 0 && !this->stalled()) {
+        const auto start = std::chrono::steady_clock::now();
+        if (call_thread_) {
+            auto args = std::make_shared<CallSnapshot>(*state, auction, offer);
+            action = call_thread_->run([vtable = export_.vtable, self = self_, call, args] {
+                return invoke(vtable, self, call, &args->state, &args->auction, &args->offer);
+            }, start + std::chrono::nanoseconds(limit));
+        } else {
+            action = invoke(export_.vtable, self_, call, state, auction, offer);
+        }
+        const uint64_t elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        if (elapsed > limit) {
+            action.reset();
+        }
+        spent_ns_ += std::min(elapsed, limit);
+    }
+    if (action) {
+        return *action;
+    }
+
+    overran_ = true;
+    overruns_++;
+    LOG(DEBUG, "Agent ", name_, " ran out of time in ", agent_call_name(call));
+    return default_action(call);
+}
+
+template <class Call>
+Action AgentAdapter::timed(AgentCall call, Call&& forward) {
+    if (!latency_) {
+        return forward();
+    }
+    const uint64_t start = stats_ticks();
+    Action action = forward();
+    latency_->calls[static_cast<size_t>(call)].record(stats_ticks_to_ns(stats_ticks() - start));
+    return action;
+}
+
+const char* agent_call_name(AgentCall call) {
+    switch (call) {
+    case AgentCall::TURN: return "agent_turn";
+    case AgentCall::AUCTION: return "auction";
+    case AgentCall::TRADE: return "trade_offer";
+    }
+    return "unknown";
 }
\ No newline at end of file
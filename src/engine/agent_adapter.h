@@ -1,10 +1,14 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <memory>
 #include "agent_abi.h"
+#include "latency_histogram.h"
 #include "plugin_loader.h"
 
+class AgentCallThread;
+
 
 struct AgentSpec {
     std::string path;
@@ -12,6 +16,33 @@ struct AgentSpec {
     std::string name;
 };
 
+// Vtable entries timed by AgentAdapter
+enum class AgentCall : uint8_t {
+    TURN,
+    AUCTION,
+    TRADE,
+};
+
+constexpr size_t NUM_AGENT_CALLS = 3;
+
+const char* agent_call_name(AgentCall call);
+
+// Latency of each decision type of one agent
+struct AgentLatency {
+    std::string name;
+    std::array<LatencyHistogram, NUM_AGENT_CALLS> calls{};
+
+    const LatencyHistogram& operator[](AgentCall call) const {
+        return calls[static_cast<size_t>(call)];
+    };
+};
+
+// Time an agent gets for its decisions, 0 = unlimited
+struct AgentBudget {
+    uint32_t call_ms = 0; // each agent_turn / auction / trade_offer call
+    uint32_t game_ms = 0; // all calls of one game together
+};
+
 // Wrapper in c++ for engine to call agents easier
 class AgentAdapter {
 public:
@@ -25,31 +56,8 @@ public:
     AgentAdapter& operator=(const AgentAdapter&) = delete;
 
     // movable
-    AgentAdapter(AgentAdapter&& other) noexcept
-        : name_(std::move(other.name_))
-        , export_(other.export_)      // assume this is trivially copyable / ok to copy
-        , self_(other.self_)
-        , handle_(std::move(other.handle_))
-    {
-        other.self_ = nullptr;        // moved-from object won’t destroy the agent
-    }
-
-    AgentAdapter& operator=(AgentAdapter&& other) noexcept {
-        if (this != &other) {
-            // clean up current resource
-            if (self_) {
-                export_.vtable.destroy_agent(self_);
-            }
-
-            name_   = std::move(other.name_);
-            export_ = other.export_;
-            self_   = other.self_;
-            handle_ = std::move(other.handle_);
-
-            other.self_ = nullptr;
-        }
-        return *this;
-    }
+    AgentAdapter(AgentAdapter&& other) noexcept;
+    AgentAdapter& operator=(AgentAdapter&& other) noexcept;
 
     void game_start(uint32_t agent_index, uint64_t seed);
     Action agent_turn(const GameStateView* state);
@@ -57,9 +65,42 @@ public:
     Action trade_offer(const GameStateView* state, const TradeOffer* offer);
 
     const std::string& name() const { return name_; };
+    uint32_t flags() const { return export_.vtable.flags; };
+
+    // Starts histograms of every vtable call from empty, or stops timing them
+    void time_calls(bool on);
+    // null unless timing
+    const AgentLatency* latency() const { return latency_.get(); };
+
+    // Limits the calls from now on, and resets the game's time and overruns. A call over budget is
+    // answered with a default action instead (end turn, no bid, reject). Thread-safe agents are
+    // called from a thread of their own, so the game moves on at the deadline; others must stay on
+    // the game thread, so only their late answers are replaced.
+    void set_budget(AgentBudget budget);
+    // Calls answered by default since set_budget
+    uint32_t overruns() const { return overruns_; };
+    // The last call was answered by default
+    bool overran() const { return overran_; };
+    // An overrun call is still running inside the agent
+    bool stalled() const;
 private:
     std::string name_;
     AgentExport export_ = {};
     void* self_ = nullptr;
-    std::unique_ptr<PluginHandle> handle_;
+    std::shared_ptr<PluginHandle> handle_;
+    std::unique_ptr<AgentLatency> latency_;
+    AgentBudget budget_;
+    uint64_t spent_ns_ = 0; // this game, counted up to the deadline of overrun calls
+    uint32_t overruns_ = 0;
+    bool overran_ = false;
+    std::unique_ptr<AgentCallThread> call_thread_; // thread-safe agents with a budget
+
+    // Destroys the agent, or leaves that to the call thread while a late call still runs
+    void destroy();
+    // Calls into the agent, within budget_ if there is one
+    Action decide(AgentCall call, const GameStateView* state, const AuctionView* auction, const TradeOffer* offer);
+
+    // Times the call into latency_ when timing
+    template <class Call>
+    Action timed(AgentCall call, Call&& forward);
 };
\ No newline at end of file
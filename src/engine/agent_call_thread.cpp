@@ -0,0 +1,71 @@
+#include "agent_call_thread.h"
+
+AgentCallThread::AgentCallThread() : shared_(std::make_shared<Shared>()) {
+    thread_ = std::thread(loop, shared_);
+}
+
+AgentCallThread::~AgentCallThread() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->stop = true;
+    }
+    shared_->cv.notify_all();
+    thread_.join();
+}
+
+std::optional<Action> AgentCallThread::run(std::function<Action()> call, std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(shared_->mutex);
+    shared_->call = std::move(call);
+    shared_->busy = true;
+    shared_->ready = false;
+    shared_->cv.notify_all();
+    if (!shared_->cv.wait_until(lock, deadline, [&] { return shared_->ready; })) {
+        return std::nullopt;
+    }
+    shared_->ready = false;
+    return shared_->result;
+}
+
+bool AgentCallThread::stalled() const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    return shared_->busy;
+}
+
+bool AgentCallThread::abandon(std::function<void()> cleanup) {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    if (!shared_->busy) {
+        return false;
+    }
+    shared_->cleanup = std::move(cleanup);
+    shared_->stop = true;
+    thread_.detach();
+    return true;
+}
+
+void AgentCallThread::loop(std::shared_ptr<Shared> shared) {
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    while (true) {
+        shared->cv.wait(lock, [&] { return shared->stop || shared->call; });
+        if (!shared->call) {
+            break;
+        }
+        // The call and whatever it captured stay alive here until it returns, late or not
+        std::function<Action()> call = std::move(shared->call);
+        shared->call = nullptr;
+        lock.unlock();
+        Action action = call();
+        lock.lock();
+        shared->result = action;
+        shared->busy = false;
+        shared->ready = true;
+        shared->cv.notify_all();
+    }
+    std::function<void()> cleanup = std::move(shared->cleanup);
+    lock.unlock();
+    if (cleanup) {
+        cleanup();
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "agent_abi.h"
+
+// One agent's decisions run on this thread, so the game thread can stop waiting at a deadline.
+// A call that misses it keeps running; the thread is stalled until the call returns, and its
+// answer is dropped.
+class AgentCallThread {
+public:
+    AgentCallThread();
+    // Joins the thread, unless abandon() left it to finish on its own
+    ~AgentCallThread();
+
+    AgentCallThread(const AgentCallThread&) = delete;
+    AgentCallThread& operator=(const AgentCallThread&) = delete;
+
+    // The call's answer, or nullopt when it was not done by deadline. Must not be called while stalled.
+    std::optional<Action> run(std::function<Action()> call, std::chrono::steady_clock::time_point deadline);
+    bool stalled() const;
+    // While stalled, detaches the thread, which runs cleanup once the late call returns. Returns
+    // false, leaving the thread as it is, when nothing is running.
+    bool abandon(std::function<void()> cleanup);
+
+private:
+    struct Shared {
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        std::function<Action()> call; // next call for the thread
+        bool busy = false; // a call is queued or running
+        bool ready = false; // result holds the answer to the last call
+        bool stop = false;
+        Action result = {};
+        std::function<void()> cleanup;
+    };
+
+    // The thread holds the state too, an abandoned thread outlives this object
+    std::shared_ptr<Shared> shared_;
+    std::thread thread_;
+
+    static void loop(std::shared_ptr<Shared> shared);
+};
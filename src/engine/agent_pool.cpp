@@ -0,0 +1,60 @@
+#include "agent_pool.h"
+#include "plugin_loader.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+std::string AgentPool::key_of(const AgentSpec& spec, uint32_t flags) {
+    std::string key = spec.path;
+    key += '\0';
+    key += spec.config_json;
+    key += '\0';
+    key += spec.name;
+    if (!(flags & AGENT_FLAG_THREAD_SAFE)) {
+        key += '\0';
+        key += std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    }
+    return key;
+}
+
+AgentAdapter AgentPool::acquire(const AgentSpec& spec) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Thread-safe and thread-bound keys differ, try both before creating
+        for (uint32_t flags : {AGENT_FLAG_THREAD_SAFE, 0u}) {
+            const std::string key = key_of(spec, flags);
+            for (auto it = idle_.rbegin(); it != idle_.rend(); it++) {
+                if (it->key == key) {
+                    AgentAdapter adapter = std::move(it->adapter);
+                    idle_.erase(std::next(it).base());
+                    return adapter;
+                }
+            }
+        }
+    }
+    return AgentAdapter(spec);
+}
+
+void AgentPool::release(const AgentSpec& spec, AgentAdapter adapter) {
+    // Still inside a call that ran out of time, destroyed once it returns
+    if (adapter.stalled()) {
+        return;
+    }
+    std::vector<AgentAdapter> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back({key_of(spec, adapter.flags()), std::move(adapter)});
+        while (idle_.size() > max_idle_) {
+            evicted.push_back(std::move(idle_.front().adapter));
+            idle_.pop_front();
+        }
+    }
+
+    // destroy_agent of undeclared plugins must not overlap a game using them
+    for (auto& agent : evicted) {
+        if (!(agent.flags() & (AGENT_FLAG_THREAD_SAFE | AGENT_FLAG_THREAD_CONFINED))) {
+            std::lock_guard<std::recursive_mutex> serial(SerialPluginMutex());
+            AgentAdapter destroyed = std::move(agent);
+        }
+    }
+}
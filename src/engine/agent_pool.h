@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include "agent_adapter.h"
+
+// Keeps idle AgentAdapters alive between games so long-lived processes skip create_agent.
+// Agents get a fresh game_start per game, which the ABI already requires them to handle.
+class AgentPool {
+public:
+    explicit AgentPool(size_t max_idle = 64) : max_idle_(max_idle) {}
+
+    // Reuses an idle agent created from the same spec, or creates a new one
+    AgentAdapter acquire(const AgentSpec& spec);
+    // Least recently used agents are destroyed once more than max_idle are parked
+    void release(const AgentSpec& spec, AgentAdapter adapter);
+
+private:
+    struct Idle {
+        std::string key;
+        AgentAdapter adapter;
+    };
+
+    // Agents that are not AGENT_FLAG_THREAD_SAFE only go back to the thread that created them
+    static std::string key_of(const AgentSpec& spec, uint32_t flags);
+
+    std::mutex mutex_;
+    std::deque<Idle> idle_;
+    size_t max_idle_;
+};
@@ -83,52 +83,166 @@ constexpr std::array<UtilityInfo,2> AllUtilities = {{
   {1, 150, {4, 10}},
 }};
 
-constexpr std::array<int8_t, 4> RailroadPositions = {5, 15, 25, 35};
-
-constexpr std::array<int8_t, 2> UtilityPositions = {12, 28};
-
-constexpr std::array<double, 40> TileProbabilities = {
-    3.0961,  // Go
-    2.1314,  // Mediterranean Avenue
-    1.8849,  // Community Chest
-    2.1624,  // Baltic Avenue
-    2.3285,  // Income Tax
-    2.9631,  // Reading Railroad
-    2.2621,  // Oriental Avenue
-    0.8650,  // Chance
-    2.3210,  // Vermont Avenue
-    2.3003,  // Connecticut Avenue
-    6.2194,  // Visiting Jail
-    2.7017,  // St. Charles Place
-    2.6040,  // Electric Company
-    2.3721,  // States Avenue
-    2.4649,  // Virginia Avenue
-    2.9200,  // Pennsylvania Railroad
-    2.7924,  // St. James Place
-    2.5945,  // Community Chest
-    2.9356,  // Tennessee Avenue
-    3.0852,  // New York Avenue
-    2.8836,  // Free Parking
-    2.8358,  // Kentucky Avenue
-    1.0480,  // Chance
-    2.7357,  // Indiana Avenue
-    3.1858,  // Illinois Avenue
-    3.0659,  // B & O Railroad
-    2.7072,  // Atlantic Avenue
-    2.6789,  // Ventnor Avenue
-    2.8074,  // Water Works
-    2.5861,  // Marvin Gardens
-    0.0000,  // Go To Jail
-    2.6774,  // Pacific Avenue
-    2.6252,  // North Carolina Avenue
-    2.3661,  // Community Chest
-    2.5006,  // Pennsylvania Avenue
-    2.4326,  // Short Line
-    0.8669,  // Chance
-    2.1864,  // Park Place
-    2.1799,  // Luxury Tax
-    2.6260,  // Boardwalk
-};
+template <size_t N>
+constexpr std::array<int8_t, N> makeTypePositions(TileType type) {
+    std::array<int8_t, N> positions{};
+    size_t count = 0;
+    for (const auto& tile : AllTiles) {
+        if (tile.type == type) {
+            positions[count++] = static_cast<int8_t>(tile.index);
+        }
+    }
+    return positions;
+}
+
+constexpr std::array<int8_t, 4> RailroadPositions = makeTypePositions<4>(TileType::Railroad);
+constexpr std::array<int8_t, 2> UtilityPositions = makeTypePositions<2>(TileType::Utility);
+constexpr uint8_t JailTile = static_cast<uint8_t>(makeTypePositions<1>(TileType::Jail)[0]);
+
+// Tile probabilities are the long-run share of rolls ending on each tile, in percent, from the
+// Markov chain of one roll. A free state is (tile, doubles rolled in a row); rolling a third
+// double, landing on Go To Jail or drawing a jail card sends the player to jail. Movement cards
+// are those of engine_cards.cpp, drawn uniformly, with its nearest-railroad/utility rule.
+enum class JailPolicy { Stay, Leave };
+
+constexpr size_t FreeStates = 40 * 3;
+constexpr size_t ChainStates = FreeStates + 3; // + in jail after 0, 1, 2 failed double rolls
+constexpr uint8_t Jailed = 40;
+
+// Same pick as the chance cards: smallest absolute distance, later position on ties
+template <size_t N>
+constexpr uint8_t nearestPosition(const std::array<int8_t, N>& positions, uint8_t from) {
+    int best = 255;
+    uint8_t nearest = from;
+    for (auto position : positions) {
+        int distance = int(from) - int(position);
+        distance = distance < 0 ? -distance : distance;
+        if (distance <= best) {
+            best = distance;
+            nearest = static_cast<uint8_t>(position);
+        }
+    }
+    return nearest;
+}
+
+// Where a roll landing on tile ends the turn, after Go To Jail and the movement cards
+template <class Emit>
+constexpr void resolveLanding(uint8_t tile, double p, Emit&& emit) {
+    const double card = p / 16;
+    switch (AllTiles[tile].type) {
+    case TileType::GoToJail:
+        emit(Jailed, p);
+        break;
+    case TileType::Community:
+        emit(0, card);      // Advance to Go
+        emit(Jailed, card); // Go to jail
+        emit(tile, 14 * card);
+        break;
+    case TileType::Chance:
+        emit(39, card);     // Boardwalk
+        emit(0, card);      // Go
+        emit(24, card);     // Illinois Avenue
+        emit(11, card);     // St. Charles Place
+        emit(nearestPosition(RailroadPositions, tile), 2 * card);
+        emit(nearestPosition(UtilityPositions, tile), card);
+        emit(static_cast<uint8_t>(tile - 3), card); // no second draw if that is community chest
+        emit(Jailed, card);
+        emit(5, card);      // Reading Railroad
+        emit(tile, 7 * card);
+        break;
+    default:
+        emit(tile, p);
+        break;
+    }
+}
+
+constexpr std::array<double, 40> makeTileProbabilities(JailPolicy policy) {
+    // Stationary distribution: (P^T - I) pi = 0 with the last equation replaced by sum(pi) = 1.
+    // Raw arrays keep the elimination below the compiler's constexpr operation limit.
+    constexpr size_t Width = ChainStates + 1;
+    struct System {
+        double a[ChainStates][Width];
+    } system{};
+    const size_t jail_entry = policy == JailPolicy::Stay ? FreeStates : JailTile * 3;
+
+    for (size_t from = 0; from < ChainStates; from++) {
+        system.a[from][from] -= 1;
+        for (int d1 = 1; d1 <= 6; d1++) {
+            for (int d2 = 1; d2 <= 6; d2++) {
+                const double p = 1.0 / 36;
+                const bool is_double = d1 == d2;
+                size_t doubles = 0;
+                uint8_t start = JailTile;
+                if (from < FreeStates) {
+                    start = static_cast<uint8_t>(from / 3);
+                    doubles = from % 3;
+                    if (is_double && doubles == 2) {
+                        system.a[jail_entry][from] += p;
+                        continue;
+                    }
+                    doubles = is_double ? doubles + 1 : 0;
+                } else if (!is_double && from < ChainStates - 1) {
+                    // Another failed attempt; the third one pays the fine and moves
+                    system.a[from + 1][from] += p;
+                    continue;
+                }
+                const uint8_t landed = static_cast<uint8_t>((start + d1 + d2) % 40);
+                resolveLanding(landed, p, [&](uint8_t tile, double mass) {
+                    const size_t to = tile == Jailed ? jail_entry : tile * 3 + doubles;
+                    system.a[to][from] += mass;
+                });
+            }
+        }
+    }
+    for (size_t col = 0; col < Width; col++) {
+        system.a[ChainStates - 1][col] = 1;
+    }
+
+    // Gaussian elimination with partial pivoting, then back substitution
+    for (size_t col = 0; col < ChainStates; col++) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < ChainStates; row++) {
+            const double candidate = system.a[row][col];
+            const double best = system.a[pivot][col];
+            if ((candidate < 0 ? -candidate : candidate) > (best < 0 ? -best : best)) {
+                pivot = row;
+            }
+        }
+        if (pivot != col) {
+            for (size_t k = col; k < Width; k++) {
+                const double swap = system.a[col][k];
+                system.a[col][k] = system.a[pivot][k];
+                system.a[pivot][k] = swap;
+            }
+        }
+        for (size_t row = col + 1; row < ChainStates; row++) {
+            const double factor = system.a[row][col] / system.a[col][col];
+            if (factor == 0) {
+                continue;
+            }
+            for (size_t k = col; k < Width; k++) {
+                system.a[row][k] -= factor * system.a[col][k];
+            }
+        }
+    }
+    double share[ChainStates]{};
+    for (size_t row = ChainStates; row-- > 0;) {
+        double sum = system.a[row][ChainStates];
+        for (size_t k = row + 1; k < ChainStates; k++) {
+            sum -= system.a[row][k] * share[k];
+        }
+        share[row] = sum / system.a[row][row];
+    }
+
+    std::array<double, 40> probabilities{};
+    for (size_t state = 0; state < ChainStates; state++) {
+        probabilities[state < FreeStates ? state / 3 : JailTile] += 100 * share[state];
+    }
+    return probabilities;
+}
+
+constexpr std::array<double, 40> TileProbabilities = makeTileProbabilities(JailPolicy::Stay);
+constexpr std::array<double, 40> TileProbabilitiesLeaveJail = makeTileProbabilities(JailPolicy::Leave);
 
 constexpr std::array<int8_t,40> makeTilePropertyIndex() {
     std::array<int8_t,40> tile_property_index{};
@@ -163,6 +277,41 @@ constexpr std::array<int8_t,40> makeTileUtilityIndex() {
     return tile_utility_index;
 }
 
+constexpr std::array<int8_t,40> makeTileOwnableIndex() {
+    std::array<int8_t,40> tile_ownable_index{};
+    tile_ownable_index.fill(-1);
+    int8_t count = 0;
+    for (const auto& tile : AllTiles) {
+        if (tile.type == TileType::Property || tile.type == TileType::Railroad || tile.type == TileType::Utility) {
+            tile_ownable_index[tile.index] = count++;
+        }
+    }
+    return tile_ownable_index;
+}
+
+constexpr std::array<OwnableInfo,28> makeOwnables() {
+    std::array<OwnableInfo,28> ownables{};
+    size_t count = 0;
+    for (const auto& tile : AllTiles) {
+        switch (tile.type) {
+        case TileType::Property: {
+            const PropertyInfo& street = AllProperties[tile.auxilary_id];
+            ownables[count++] = {tile.index, tile.type, tile.colour, street.house_cost, street.purchase_price};
+            break;
+        }
+        case TileType::Railroad:
+            ownables[count++] = {tile.index, tile.type, Colour::None, 0, AllRailRoads[tile.auxilary_id].purchase_price};
+            break;
+        case TileType::Utility:
+            ownables[count++] = {tile.index, tile.type, Colour::None, 0, AllUtilities[tile.auxilary_id].purchase_price};
+            break;
+        default:
+            break;
+        }
+    }
+    return ownables;
+}
+
 constexpr std::array<ColourGroup, 9> makeColourToTiles() {
     std::array<ColourGroup, 9> result{};
     for (const auto& tile : AllTiles) {
@@ -176,6 +325,28 @@ constexpr std::array<ColourGroup, 9> makeColourToTiles() {
     return result;
 }
 
+constexpr uint32_t makeTypeMask(TileType type) {
+    const auto tile_ownable_index = makeTileOwnableIndex();
+    uint32_t mask = 0;
+    for (const auto& tile : AllTiles) {
+        if (tile.type == type) {
+            mask |= 1u << tile_ownable_index[tile.index];
+        }
+    }
+    return mask;
+}
+
+constexpr std::array<uint32_t, 9> makeColourMasks() {
+    const auto tile_ownable_index = makeTileOwnableIndex();
+    std::array<uint32_t, 9> result{};
+    for (const auto& tile : AllTiles) {
+        if (tile.type == TileType::Property) {
+            result[static_cast<size_t>(tile.colour)] |= 1u << tile_ownable_index[tile.index];
+        }
+    }
+    return result;
+}
+
 struct BoardHolder {
     Board board;
     constexpr BoardHolder() : board{} {
@@ -187,12 +358,19 @@ struct BoardHolder {
         board.railroad_positions = RailroadPositions;
         board.utility_positions = UtilityPositions;
         board.tile_probability = TileProbabilities;
+        board.tile_probability_leave_jail = TileProbabilitiesLeaveJail;
 
         board.tile_property_index = makeTilePropertyIndex();
         board.tile_railroad_index = makeTileRailroadIndex();
         board.tile_utility_index = makeTileUtilityIndex();
+        board.tile_ownable_index = makeTileOwnableIndex();
+        board.ownables = makeOwnables();
 
         board.colour_to_tiles = makeColourToTiles();
+        board.colour_masks = makeColourMasks();
+        board.street_mask = makeTypeMask(TileType::Property);
+        board.railroad_mask = makeTypeMask(TileType::Railroad);
+        board.utility_mask = makeTypeMask(TileType::Utility);
     }
 };
 
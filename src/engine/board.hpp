@@ -54,6 +54,15 @@ struct UtilityInfo {
     std::array<uint16_t,2> multiplier;
 };
 
+// Static data of one ownable tile, indexed like a game's 28 ownable properties
+struct OwnableInfo {
+    uint8_t tile;
+    TileType type;
+    Colour colour; // None off streets
+    uint8_t house_cost; // 0 off streets
+    uint16_t purchase_price;
+};
+
 struct Board {
     // Tiles in order
     std::array<TileInfo,40> tiles{};
@@ -67,12 +76,23 @@ struct Board {
     std::array<int8_t,40> tile_property_index{};
     std::array<int8_t,40> tile_railroad_index{};
     std::array<int8_t,40> tile_utility_index{};
+    // index into a game's 28 ownable tiles (streets, railroads, utilities in board order), -1 otherwise
+    std::array<int8_t,40> tile_ownable_index{};
+    std::array<OwnableInfo,28> ownables{};
 
     std::array<ColourGroup, 9> colour_to_tiles{};
-    std::array<int8_t, 4> railroad_positions{}; // TODO in cpp
-    std::array<int8_t, 2> utility_positions{}; // TODO in cpp
-
-    std::array<double, 40> tile_probability{}; // TODO in cpp
+    // bitmasks over ownable indices (tile_ownable_index)
+    std::array<uint32_t, 9> colour_masks{};
+    uint32_t street_mask = 0;
+    uint32_t railroad_mask = 0;
+    uint32_t utility_mask = 0;
+    std::array<int8_t, 4> railroad_positions{};
+    std::array<int8_t, 2> utility_positions{};
+
+    // Percent of rolls ending on each tile, solved from the board's Markov chain at compile time.
+    // tile_probability assumes jailed players try for doubles; with leave_jail they pay out at once.
+    std::array<double, 40> tile_probability{};
+    std::array<double, 40> tile_probability_leave_jail{};
 
     constexpr const PropertyInfo* propertyByTile(uint8_t tile_id) const {
         int8_t id = tile_property_index[tile_id];
@@ -87,6 +107,14 @@ struct Board {
         return tile_utility_index[tile_id];
     }
 
+    constexpr int ownableByTile(uint8_t tile_id) const {
+        return tile_ownable_index[tile_id];
+    }
+
+    constexpr uint32_t colourMask(Colour c) const {
+        return colour_masks[static_cast<size_t>(c)];
+    }
+
     constexpr const ColourGroup& tilesOfColour(Colour c) const {
         return colour_to_tiles[static_cast<size_t>(c)];
     }
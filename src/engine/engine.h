@@ -4,16 +4,26 @@
 #include <string>
 #include <random>
 #include <optional>
+#include <memory>
 #include "state_view.h"
 #include "agent_abi.h"
 #include "agent_adapter.h"
 #include "board.hpp"
+#include "game_state.h"
+#include "game_stats.h"
 
 struct GameConfig {
   uint64_t game_id;
   uint64_t seed;
   uint32_t max_turns;
   std::vector<AgentSpec> agent_specs;
+  bool reshuffle_decks = false; // reshuffle a deck once all its cards are drawn, instead of cycling it in order
+  RngBackend rng = RngBackend::MT19937;
+  std::string log_path; // if set, a replay log of the game is written there (replay_log.h)
+  bool collect_stats = false; // per-phase counts and times in GameResult::stats
+  AgentBudget budget; // agents' time per call and per game, overruns in GameResult::overruns
+  AuctionMode auction_mode = AuctionMode::ROUNDS;
+  uint32_t auction_increment = 10; // PROXY only, at least 1
 };
 
 struct GameResult {
@@ -24,6 +34,20 @@ struct GameResult {
     std::vector<double> penalties;
     GameStateView final_state;
     std::string log_path;
+    std::optional<GameStats> stats; // with GameConfig::collect_stats
+    std::vector<uint32_t> overruns; // per player, calls over the time budget; empty without a budget
+
+    // Snapshot final_state points into, so results outlive their Engine
+    std::vector<PlayerView> final_players;
+    std::vector<PropertyView> final_properties;
+
+    // final_state re-pointed at this result's own snapshot, safe after copies
+    GameStateView final_view() const {
+        GameStateView view = final_state;
+        view.players = final_players.data();
+        view.properties = final_properties.data();
+        return view;
+    };
 };
 
 struct RollResult {
@@ -35,27 +59,69 @@ struct RollResult {
     };
 };
 
+class AgentPool;
+class ReplayWriter;
+class ReplayReader;
+
+// Decisions the rules need from players. Games with agents route these to the plugins;
+// search code can plug in cheap default policies instead.
+class Policy {
+public:
+    virtual ~Policy() = default;
+    virtual Action agent_turn(const GameState& state, uint32_t player_index) = 0;
+    virtual Action auction(const GameState& state, uint32_t player_index, const AuctionView& auction) = 0;
+    virtual Action trade_offer(const GameState& state, uint32_t player_index, const TradeOffer& offer) = 0;
+};
+
 class Engine {
 public:
-    explicit Engine(GameConfig cfg);
+    // With a pool, agents are borrowed from it and handed back when the engine is destroyed
+    explicit Engine(GameConfig cfg, AgentPool* pool = nullptr);
+    // Continues from a copied position, asking policy for every decision. No agents are loaded.
+    // With a replay log, dice and reshuffles are read from it instead of the rng.
+    Engine(const GameState& state, Policy& policy, ReplayReader* replay = nullptr);
+    ~Engine();
     GameResult run();
 
+    // Stepping API, one player turn at a time. state().properties is current after each call.
+    const GameState& state() const { return state_; };
+    bool game_over() const;
+    int winner() const; // only remaining player, -1 if none/several
+
+    // Rolls (or takes the given roll) and resolves the landing tile. Returns false when the
+    // player has no action phase this turn (retired, jailed by doubles, went bankrupt); the
+    // turn has then already passed to the next player.
+    bool start_turn();
+    bool start_turn(RollResult roll);
+    // Applies one action of the active player, true once their action phase is over
+    bool apply_action(const Action& action);
+    // Auctions an unbought landed property, clears per-turn flags and passes the turn
+    void end_turn();
+    // Full turn with the active player's decisions taken from the policy
+    void play_turn();
+
 private:
+    friend class EngineBench; // microbenchmarks of the private rules, src/bench/monopoly_bench.cpp
+
     GameConfig cfg_;
-    std::mt19937_64 rng_;
+    AgentPool* pool_;
     const Board& board_;
-    std::uniform_int_distribution<int> dice_;
     std::vector<AgentAdapter> agent_adapters_;
-    GameStateView state_;
-    std::vector<int> position_to_properties_;
-    std::vector<PlayerView> players_;
-    std::vector<double> penalties_;
-    std::vector<PropertyView> properties_;
-
-    std::vector<uint32_t> community_deck_;
-    std::vector<uint32_t> chance_deck_;
-
-    void init_setup();
+    std::unique_ptr<Policy> agent_policy_;
+    Policy* policy_;
+    GameState state_;
+    std::unique_ptr<ReplayWriter> recorder_;
+    ReplayReader* replay_ = nullptr;
+    std::unique_ptr<PhaseCounters> counters_; // null unless cfg_.collect_stats
+
+    bool begin_turn(const RollResult* roll);
+    void next_player();
+
+    Action ask_turn(uint32_t player_index);
+    Action ask_auction(uint32_t player_index, const AuctionView& auction);
+    Action ask_trade(uint32_t player_index, const TradeOffer& offer);
+    // Penalizes a player whose agent ran out of time on the last decision
+    void check_overrun(uint32_t player_index);
 
     RollResult dice_roll();
 
@@ -79,25 +145,32 @@ private:
     uint32_t get_street_rent(PlayerView& player, const PropertyInfo* street);
     uint32_t get_railroad_rent(PlayerView& player, const int railroadIndex);
     uint32_t get_utility_rent(PlayerView& player, const int utilityIndex, bool max_rent);
-    void update_rent(PropertyView& property);
-    bool developed_monopoly(PropertyView* property);
+    void update_rent(uint32_t index);
+    void refresh_street_rents(uint32_t index, const PropertyInfo* street);
+    void refresh_railroad_rents(uint32_t owner_index, bool include_mortgaged);
+    void refresh_utility_rents(uint32_t owner_index);
+    bool developed_monopoly(uint32_t index);
     bool is_monopoly(const PropertyInfo* street, bool active_monopoly);
 
-    // engine_finance.cpp
+    // engine_finance.cpp, properties are indices into the state's property arrays
     bool raise_fund(PlayerView& player, uint32_t owed);
-    void pay_by_mortgage(PlayerView& player, std::vector<PropertyView*> undeveloped_assets, uint32_t amount);
-    void pay_by_houses(PlayerView& player, std::vector<PropertyView*> developed_assets, uint32_t amount);
-    void mortgage(PlayerView& player, PropertyView* property);
-    void unmortgage(PlayerView& player, PropertyView* property);
-    void auction(PropertyView* property);
+    void pay_by_mortgage(PlayerView& player, uint32_t undeveloped_assets, uint32_t amount);
+    void pay_by_houses(PlayerView& player, uint32_t developed_assets, uint32_t amount);
+    void mortgage(PlayerView& player, uint32_t index);
+    void unmortgage(PlayerView& player, uint32_t index);
+    void auction(uint32_t index);
+    // Bidding of one auction, the winner's seat (-1 for none) and the price they pay
+    int bidding_rounds(uint32_t index, uint32_t& price);
+    int proxy_bidding(uint32_t index, uint32_t& price);
     void bankrupt(PlayerView& player, PlayerView* debtor);
 
     // engine_property.cpp
-    void buy_property(PlayerView& player, PropertyView* property);
-    void sell_house(PlayerView& player, PropertyView* property);
-    void build_house(PlayerView& player, PropertyView* property);
+    void buy_property(PlayerView& player, uint32_t index);
+    void sell_house(PlayerView& player, uint32_t index);
+    void build_house(PlayerView& player, uint32_t index);
 
     // engine_cards.cpp
+    uint32_t draw_card(CardDeck& deck, uint8_t deck_id);
     void community_card_draw(PlayerView& player);
     bool chance_card_draw(PlayerView& player);
 
@@ -1,11 +1,28 @@
 #include "engine.h"
 #include "board.hpp"
+#include "replay_log.h"
+#include <bit>
 #include <cassert>
 #include <iostream>
 
+// Reshuffles go through here so replay logs can record and supply them
+uint32_t Engine::draw_card(CardDeck& deck, uint8_t deck_id) {
+    if (deck.reshuffle && deck.undrawn == 0) {
+        if (this->replay_) {
+            this->replay_->shuffle(deck_id, deck);
+        } else {
+            deck.shuffle(this->state_.rng);
+        }
+        if (this->recorder_) {
+            this->recorder_->shuffle(deck_id, deck);
+        }
+    }
+    return deck.draw(this->state_.rng);
+}
+
 void Engine::community_card_draw(PlayerView& player) {
-    uint32_t drawn_card = this->community_deck_[0];
-    this->community_deck_.erase(this->community_deck_.begin());
+    PhaseTimer timer(this->counters_.get(), Phase::CARD_DRAW);
+    uint32_t drawn_card = this->draw_card(this->state_.community_deck, 0);
     assert(drawn_card < 16);
 
     switch (drawn_card)
@@ -37,6 +54,7 @@ void Engine::community_card_draw(PlayerView& player) {
     case 4:
         // Get out of jail free card
         player.jail_free_cards += 1;
+        this->state_.community_deck.jail_card_out = true;
         return;
     case 5:
         // Go to jail
@@ -44,7 +62,7 @@ void Engine::community_card_draw(PlayerView& player) {
         break;
     case 6: {
         // Grand Opera Night, colelct $50 from each player
-        for (auto& other_player : this->players_) {
+        for (auto& other_player : this->state_.seated_players()) {
             if (player.player_index == other_player.player_index || other_player.retired) {
                 continue;
             }
@@ -69,7 +87,7 @@ void Engine::community_card_draw(PlayerView& player) {
         break;
     case 9: {
         // Birthday, collect $10 from each player
-        for (auto& other_player : this->players_) {
+        for (auto& other_player : this->state_.seated_players()) {
             if (player.player_index == other_player.player_index || other_player.retired) {
                 continue;
             }
@@ -117,14 +135,12 @@ void Engine::community_card_draw(PlayerView& player) {
     case 14: {
         // Street repairs, pay $40 per house and $115 per hotel
         uint32_t repair_cost = 0;
-        for (auto& property : this->properties_) {
-            if (property.owner_index != player.player_index || property.type != PropertyType::PROPERTY) {
-                continue;
-            }
-            if (property.hotel) {
+        for (uint32_t bits = this->state_.developed_by(player.player_index) & this->board_.street_mask; bits; bits &= bits - 1) {
+            const uint8_t houses = this->state_.houses[std::countr_zero(bits)];
+            if (houses == GameState::HOTEL) {
                 repair_cost += 115;
             } else {
-                repair_cost += 40 * property.houses;
+                repair_cost += 40 * houses;
             }
         }
 
@@ -142,12 +158,12 @@ void Engine::community_card_draw(PlayerView& player) {
         player.cash += 10;
         break;
     }
-    this->community_deck_.push_back(drawn_card);
+    this->state_.community_deck.push_back(drawn_card);
 }
 
 bool Engine::chance_card_draw(PlayerView& player) {
-    uint32_t drawn_card = this->chance_deck_[0];
-    this->chance_deck_.erase(this->chance_deck_.begin());
+    PhaseTimer timer(this->counters_.get(), Phase::CARD_DRAW);
+    uint32_t drawn_card = this->draw_card(this->state_.chance_deck, 1);
     assert(drawn_card < 16);
     switch (drawn_card)
     {
@@ -189,7 +205,7 @@ bool Engine::chance_card_draw(PlayerView& player) {
         }
         assert(closest_railroad > 0);
         player.position = closest_railroad;
-        this->chance_deck_.push_back(drawn_card);
+        this->state_.chance_deck.push_back(drawn_card);
         return true;
     }
     case 6: {
@@ -206,7 +222,7 @@ bool Engine::chance_card_draw(PlayerView& player) {
         }
         assert(closest_utility > 0);
         player.position = closest_utility;
-        this->chance_deck_.push_back(drawn_card);
+        this->state_.chance_deck.push_back(drawn_card);
         return true;
     }
     case 7:
@@ -216,6 +232,7 @@ bool Engine::chance_card_draw(PlayerView& player) {
     case 8:
         // Get out of jail free card
         player.jail_free_cards += 1;
+        this->state_.chance_deck.jail_card_out = true;
         return false;
     case 9:
         // Go Back 3 Spaces
@@ -229,14 +246,12 @@ bool Engine::chance_card_draw(PlayerView& player) {
     case 11: {
         // Street repairs, pay $20 per house and $100 per hotel
         uint32_t repair_cost = 0;
-        for (auto& property : this->properties_) {
-            if (property.owner_index != player.player_index || property.type != PropertyType::PROPERTY) {
-                continue;
-            }
-            if (property.hotel) {
+        for (uint32_t bits = this->state_.developed_by(player.player_index) & this->board_.street_mask; bits; bits &= bits - 1) {
+            const uint8_t houses = this->state_.houses[std::countr_zero(bits)];
+            if (houses == GameState::HOTEL) {
                 repair_cost += 100;
             } else {
-                repair_cost += 25 * property.houses;
+                repair_cost += 25 * houses;
             }
         }
 
@@ -268,7 +283,7 @@ bool Engine::chance_card_draw(PlayerView& player) {
         player.position = 5;
     case 14: {
         // You have been elected Chairman of the Board. Pay each player $50.
-        for (auto& other_player : this->players_) {
+        for (auto& other_player : this->state_.seated_players()) {
             if (player.player_index == other_player.player_index || other_player.retired) {
                 continue;
             }
@@ -288,6 +303,6 @@ bool Engine::chance_card_draw(PlayerView& player) {
         player.cash += 150;
         break;
     }
-    this->chance_deck_.push_back(drawn_card);
+    this->state_.chance_deck.push_back(drawn_card);
     return false;
 }
\ No newline at end of file
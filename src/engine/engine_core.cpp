@@ -1,139 +1,213 @@
 #include "engine.h"
 #include "board.hpp"
+#include "replay_log.h"
+#include "log.h"
 #include <fstream>
 #include <cstdint>
+#include <bit>
 #include <set>
 #include <cassert>
 #include <algorithm>
-#include <iostream>
+#include <array>
 
 GameResult Engine::run() {
-    std::cerr << "Running agent\n";
-    int turn = 0;
-    int winner = -1;
-    while (turn < cfg_.max_turns)
-    {
-        assert(players_.size() == agent_adapters_.size());
-        int active_players = 0;
-        int active_index = -1;
-        for (size_t i = 0; i < this->players_.size(); i++) {
-            PlayerView& player = this->players_[i];
-            if (!player.retired) {
-                active_index = i;
-                active_players++;
+    LOG(DEBUG, "Game ", this->cfg_.game_id, " running");
+    if (this->counters_) {
+        this->counters_->start = stats_ticks();
+    }
+    while (!this->game_over()) {
+        this->play_turn();
+    }
+    // Running out of turns is a draw, even with a single player left
+    int winner = this->state_.turn < this->state_.max_turns ? this->winner() : -1;
+
+    GameResult result = {
+        this->cfg_.game_id,
+        this->state_.turn,
+        winner,
+        this->get_player_scores(),
+        std::vector<double>(this->state_.penalties.begin(), this->state_.penalties.begin() + this->state_.num_players),
+        this->state_.view(),
+    };
+    auto players = this->state_.seated_players();
+    result.final_players.assign(players.begin(), players.end());
+    result.final_properties.assign(this->state_.properties.begin(), this->state_.properties.end());
+    result.final_state = result.final_view();
+    if (this->cfg_.budget.call_ms || this->cfg_.budget.game_ms) {
+        for (const AgentAdapter& adapter : this->agent_adapters_) {
+            result.overruns.push_back(adapter.overruns());
+        }
+    }
+    if (this->counters_) {
+        result.stats = this->counters_->finish();
+        for (const AgentAdapter& adapter : this->agent_adapters_) {
+            if (adapter.latency()) {
+                result.stats->agents.push_back(*adapter.latency());
             }
         }
+    }
 
-        if (active_players <= 1) {
-            winner = active_index;
-            break;
+    if (this->recorder_) {
+        this->recorder_->end({this->state_.turn, winner, state_digest(this->state_)});
+        this->recorder_->save(this->cfg_.log_path);
+        result.log_path = this->cfg_.log_path;
+    }
+
+    return result;
+}
+
+// Games end only between rounds, so the last survivor still finishes the round it won in
+bool Engine::game_over() const {
+    if (this->state_.turn >= this->state_.max_turns) {
+        return true;
+    }
+    if (this->state_.active_player != 0) {
+        return false;
+    }
+    int active_players = 0;
+    for (const auto& player : this->state_.seated_players()) {
+        if (!player.retired) {
+            active_players++;
         }
-        for (auto it = this->players_.begin(); it != this->players_.end(); it++) {
-            auto& player = *it;
-            assert(player.player_index < 5);
-            if (player.retired) {
-                continue;
-            }
+    }
+    return active_players <= 1;
+}
 
-            if (player.turns_in_jail == 2) {
-                player.turns_in_jail = 0;
-                player.in_jail = false;
-            }
+int Engine::winner() const {
+    int active_players = 0;
+    int active_index = -1;
+    for (const auto& player : this->state_.seated_players()) {
+        if (!player.retired) {
+            active_index = player.player_index;
+            active_players++;
+        }
+    }
+    return active_players == 1 ? active_index : -1;
+}
 
-            if (!this->in_jail(player)) {
-                RollResult dice_roll = this->dice_roll();
-                bool in_jail = update_position(player, dice_roll);
-                if (in_jail) {
-                    continue;
-                }
-                this->handle_position(player);
-                if (player.retired) {
-                    continue;
-                }
-            } else {
-                player.turns_in_jail++;
-            }
+bool Engine::start_turn() {
+    const bool action_phase = this->begin_turn(nullptr);
+    this->state_.sync_properties();
+    return action_phase;
+}
 
-            uint32_t index = player.player_index;
-            AgentAdapter& agent = this->agent_adapters_[index];
-            while (true) {
-                this->state_.current_player_index = player.player_index;
-                Action agent_action = agent.agent_turn(&this->state_);
-                if (this->handle_action(player, agent_action)) {
-                    break;
-                }
-                if (player.retired) {
-                    break;
-                }
-            }
-            
+bool Engine::start_turn(RollResult roll) {
+    const bool action_phase = this->begin_turn(&roll);
+    this->state_.sync_properties();
+    return action_phase;
+}
 
-            int property_index = this->position_to_properties_[player.position];
-            if (property_index != -1) {
-                PropertyView& property_on = this->properties_[property_index];
-                if (!property_on.auctioned_this_turn && !property_on.is_owned) {
-                    this->auction(&property_on);
-                }
-                property_on.auctioned_this_turn = false;
-            }
-            player.jail_rolled_this_turn = false;
+bool Engine::begin_turn(const RollResult* roll) {
+    PlayerView& player = this->state_.players[this->state_.active_player];
+    if (player.retired) {
+        this->next_player();
+        return false;
+    }
 
-            player.trades_offered = 0;
-            player.previous_offer = {};
-            player.offer_accepted = false;
+    if (player.turns_in_jail == 2) {
+        player.turns_in_jail = 0;
+        player.in_jail = false;
+    }
+
+    if (!this->in_jail(player)) {
+        RollResult dice_roll = roll ? *roll : this->dice_roll();
+        bool in_jail = update_position(player, dice_roll);
+        if (in_jail) {
+            this->next_player();
+            return false;
         }
-        turn++;
+        this->handle_position(player);
+        if (player.retired) {
+            this->next_player();
+            return false;
+        }
+    } else {
+        player.turns_in_jail++;
     }
+    return true;
+}
 
-    GameResult result = {
-        this->cfg_.game_id,
-        static_cast<uint64_t>(turn),
-        winner,
-        this->get_player_scores(),
-        this->penalties_,
-        this->state_,
-    };
+bool Engine::apply_action(const Action& action) {
+    PlayerView& player = this->state_.players[this->state_.active_player];
+    const bool done = this->handle_action(player, action) || player.retired;
+    this->state_.sync_properties();
+    return done;
+}
 
-    return result;
+void Engine::end_turn() {
+    PlayerView& player = this->state_.players[this->state_.active_player];
+    int property_index = this->board_.ownableByTile(player.position);
+    if (property_index != -1) {
+        if (!this->state_.was_auctioned(property_index) && !this->state_.is_owned(property_index)) {
+            this->auction(property_index);
+        }
+        if (this->state_.was_auctioned(property_index)) {
+            this->state_.set_auctioned(property_index, false);
+        }
+    }
+    player.jail_rolled_this_turn = false;
+
+    player.trades_offered = 0;
+    player.previous_offer = {};
+    player.offer_accepted = false;
+    this->next_player();
+    this->state_.sync_properties();
+}
+
+void Engine::play_turn() {
+    if (!this->start_turn()) {
+        return;
+    }
+    const uint32_t index = this->state_.active_player;
+    while (!this->apply_action(this->ask_turn(index))) {
+    }
+    this->end_turn();
+}
+
+void Engine::next_player() {
+    this->state_.active_player++;
+    if (this->state_.active_player == this->state_.num_players) {
+        this->state_.active_player = 0;
+        this->state_.turn++;
+    }
 }
 
 bool Engine::handle_action(PlayerView& player, Action player_action) {
     switch (player_action.type) {
     case (ActionType::ACTION_LANDED_PROPERTY): {
-        int index = this->position_to_properties_[player.position];
+        int index = this->board_.ownableByTile(player.position);
         if (player_action.buying_property) {
             if (index == -1) {
                 this->penalize(player, "purchase attempt of non-property");
                 return true;
             } else {
-                PropertyView* property = &this->properties_[index];
-                if (property->owner_index != -1) {
+                if (this->state_.is_owned(index)) {
                     this->penalize(player, "purchase attempt of owned property");
                     return true;
                 }
-                this->buy_property(player, property);
+                this->buy_property(player, index);
             }
         } else {
             if (index == -1) {
                 this->penalize(player, "auction attempt of non-property");
                 return true;
             }else {
-                PropertyView* property = &this->properties_[index];
-                if (property->auctioned_this_turn) {
+                if (this->state_.was_auctioned(index)) {
                     this->penalize(player, "attempt of multi-auction of same property");
-                    property->auctioned_this_turn = false;
+                    this->state_.set_auctioned(index, false);
                     return true;
                 }
-                property->auctioned_this_turn = true;
-                this->auction(property);
+                this->state_.set_auctioned(index, true);
+                this->auction(index);
             }
         }
         break;
     }
     case (ActionType::ACTION_TRADE): {
+        PhaseTimer timer(this->counters_.get(), Phase::TRADE);
         TradeOffer& offer = player_action.trade_offer;
         uint32_t player_index_to_offer = offer.player_to_offer;
-        PlayerView& player_to_offer = this->players_[player_index_to_offer];
+        PlayerView& player_to_offer = this->state_.players[player_index_to_offer];
         TradeDetail& assets_offered = offer.offer_from;
         TradeDetail& assets_demanded = offer.offer_to;
 
@@ -163,8 +237,7 @@ bool Engine::handle_action(PlayerView& player, Action player_action) {
             return true;
         }
 
-        this->state_.current_player_index = this->players_[player_index_to_offer].player_index;
-        Action trade_response = this->agent_adapters_[player_index_to_offer].trade_offer(&this->state_, &offer);
+        Action trade_response = this->ask_trade(player_to_offer.player_index, offer);
         if (trade_response.type != ACTION_TRADE_RESPONSE) {
             this->penalize(player_to_offer, "incoherent response to trade request");
             return true;
@@ -185,61 +258,58 @@ bool Engine::handle_action(PlayerView& player, Action player_action) {
         return true;
     case (ActionType::ACTION_MORTGAGE): {
         uint32_t position = player_action.property_position;
-        int index = this->position_to_properties_[position];
+        int index = this->board_.ownableByTile(position);
         if (index == -1) {
             // not a property
             this->penalize(player, "mortgage attempt of non-property");
             return true;
         }
 
-        PropertyView* property = &this->properties_[index];
-        if (property->owner_index != player.player_index || property->houses > 0 || property->mortgaged) {
+        if (this->state_.owner_of(index) != player.player_index || this->state_.houses[index] > 0 || this->state_.is_mortgaged(index)) {
             this->penalize(player, "mortgage attempt of non-belonging property");
             return true;
         }
 
-        this->mortgage(player, property);
+        this->mortgage(player, index);
         break;
     }
     case (ActionType::ACTION_UNMORTGAGE): {
         uint32_t position = player_action.property_position;
-        int index = this->position_to_properties_[position];
+        int index = this->board_.ownableByTile(position);
         if (index == -1) {
             // not a property
             this->penalize(player, "unmortgage attempt of non-property");
             return true;
         }
 
-        PropertyView* property = &this->properties_[index];
-        if (property->owner_index != player.player_index || !property->mortgaged) {
+        if (this->state_.owner_of(index) != player.player_index || !this->state_.is_mortgaged(index)) {
             this->penalize(player, "unmortgage attempt of non-owned/non-mortgaged property");
             return true;
         }
 
-        if (player.cash <= (property->purchase_price / 2) * 1.1) {
+        if (player.cash <= (this->board_.ownables[index].purchase_price / 2) * 1.1) {
             this->penalize(player, "unmortgage attempt without sufficient cash");
             return true;
         }
 
-        this->unmortgage(player, property);
+        this->unmortgage(player, index);
         break;
     }
     case (ActionType::ACTION_DEVELOP): {
         uint32_t position = player_action.property_position;
-        int index = this->position_to_properties_[position];
+        int index = this->board_.ownableByTile(position);
         if (index == -1) {
             this->penalize(player, "develop attempt of non-property");
             return true;
         }
 
-        PropertyView* property = &this->properties_[index];
-        if (property->owner_index != player.player_index || property->houses == 5) {
+        if (this->state_.owner_of(index) != player.player_index || this->state_.houses[index] == GameState::HOTEL) {
             // Does not own property / property already fully developed
             this->penalize(player, "develop attempt of non-belonging/fully-developed property");
             return true;
         }
 
-        const PropertyInfo* property_info = this->board_.propertyByTile(property->position);
+        const PropertyInfo* property_info = this->board_.propertyByTile(position);
 
         if (!this->is_monopoly(property_info, true)) {
             // Not a monopoly, cant build
@@ -247,31 +317,30 @@ bool Engine::handle_action(PlayerView& player, Action player_action) {
             return true;
         }
 
-        if (player.cash < property->house_price) {
+        if (player.cash < this->board_.ownables[index].house_cost) {
             // cannot afford a house
             this->penalize(player, "develop attempt without sufficient cash");
             return true;
         }
 
-        this->build_house(player, property);
+        this->build_house(player, index);
         break;
     }
     case (ActionType::ACTION_UNDEVELOP): {
         uint32_t position = player_action.property_position;
-        int index = this->position_to_properties_[position];
+        int index = this->board_.ownableByTile(position);
         if (index == -1) {
             this->penalize(player, "undevelop attempt of non-property");
             return true;
         }
 
-        PropertyView* property = &this->properties_[index];
-        if (property->owner_index != player.player_index || property->houses == 0) {
+        if (this->state_.owner_of(index) != player.player_index || this->state_.houses[index] == 0) {
             // Does not own property / no houses on property
             this->penalize(player, "undevelop attempt of non-belonging/undeveloped property");
             return true;
         }
 
-        this->sell_house(player, property);
+        this->sell_house(player, index);
         break;
     }
     case (ActionType::ACTION_AUCTION_BID):
@@ -372,6 +441,7 @@ bool Engine::update_position(PlayerView& player, RollResult diceroll) {
 }
 
 void Engine::handle_position(PlayerView& player) {
+    PhaseTimer timer(this->counters_.get(), Phase::HANDLE_POSITION);
     bool max_rent = false;
     switch (this->board_.tiles[player.position].type) {
     case (TileType::Chance):
@@ -396,9 +466,10 @@ void Engine::handle_position(PlayerView& player) {
     case (TileType::Property):
     case (TileType::Railroad):
     case (TileType::Utility): {
-        int index = this->position_to_properties_[player.position];
-        PropertyView& property = this->properties_[index];
-        debtor = &this->players_[property.owner_index];
+        int index = this->board_.ownableByTile(player.position);
+        if (this->state_.is_owned(index)) {
+            debtor = &this->state_.players[this->state_.owner_of(index)];
+        }
         rent = get_rent(player, max_rent);
         break;
     }
@@ -437,8 +508,8 @@ void Engine::handle_position(PlayerView& player) {
 }
 
 void Engine::penalize(PlayerView& player, const std::string& reason) {
-    this->penalties_[player.player_index] += 0.5;
-    //std::cout << reason << "\n";
+    this->state_.penalties[player.player_index] += 0.5;
+    LOG(TRACE, "Game ", this->cfg_.game_id, ": player ", player.player_index, " penalized, ", reason);
 }
 
 void Engine::jail(PlayerView& player) {
@@ -454,26 +525,41 @@ bool Engine::in_jail(PlayerView& player) {
 
 void Engine::use_jail_free_card(PlayerView& player) {
     player.jail_free_cards -= 1;
-    assert(this->community_deck_.size() != 16 || this->chance_deck_.size() != 16);
+    assert(this->state_.community_deck.jail_card_out || this->state_.chance_deck.jail_card_out);
 
-    if (this->community_deck_.size() != 16) {
-        this->community_deck_.push_back(4);
+    if (this->state_.community_deck.jail_card_out) {
+        this->state_.community_deck.jail_card_out = false;
+        this->state_.community_deck.push_back(GameState::COMMUNITY_JAIL_CARD);
     } else {
-        this->chance_deck_.push_back(8);
+        this->state_.chance_deck.jail_card_out = false;
+        this->state_.chance_deck.push_back(GameState::CHANCE_JAIL_CARD);
+    }
+}
+
+namespace {
+constexpr std::array<RollResult, 36> DICE_OUTCOMES = [] {
+    std::array<RollResult, 36> outcomes{};
+    for (int i = 0; i < 36; i++) {
+        outcomes[i] = {i / 6 + 1, i % 6 + 1, i / 6 == i % 6};
     }
+    return outcomes;
+}();
 }
 
 RollResult Engine::dice_roll() {
-    int roll1 = dice_(rng_);
-    int roll2 = dice_(rng_);
-    return {roll1, roll2, roll1 == roll2};
+    PhaseTimer timer(this->counters_.get(), Phase::DICE);
+    const uint32_t outcome = this->replay_ ? this->replay_->roll() : this->state_.rng.roll();
+    if (this->recorder_) {
+        this->recorder_->roll(outcome);
+    }
+    return DICE_OUTCOMES[outcome];
 }
 
 std::vector<double> Engine::get_player_scores() {
     std::vector<double> scores;
 
-    for (int i = 0; i < this->players_.size(); i++) {
-        scores.push_back(this->networth(players_[i]) + 4 * this->expected_income(players_[i]));
+    for (auto& player : this->state_.seated_players()) {
+        scores.push_back(this->networth(player) + 4 * this->expected_income(player));
     }
     return scores;
 }
@@ -483,15 +569,13 @@ double Engine::networth(PlayerView& player) {
 
     networth += player.cash;
     
-    for (PropertyView& property : this->properties_) {
-        if (property.owner_index != player.player_index) {
-            continue;
-        }
-
+    for (uint32_t bits = this->state_.owned_by(player.player_index); bits; bits &= bits - 1) {
+        const uint32_t index = std::countr_zero(bits);
+        const OwnableInfo& info = this->board_.ownables[index];
         double property_worth = 0;
-        property_worth += property.purchase_price;
-        if (property.type == PropertyType::PROPERTY) {
-            property_worth += property.house_price * property.houses;
+        property_worth += info.purchase_price;
+        if (info.type == TileType::Property) {
+            property_worth += info.house_cost * this->state_.houses[index];
         }
         networth += property_worth;
     }
@@ -501,11 +585,9 @@ double Engine::networth(PlayerView& player) {
 double Engine::expected_income(PlayerView& player) {
     double expected_income = 0;
 
-    for (PropertyView& property : this->properties_) {
-        if (property.owner_index != player.player_index) {
-            continue;
-        }
-        expected_income += this->board_.tile_probability[property.position] * property.current_rent;
+    for (uint32_t bits = this->state_.owned_by(player.player_index); bits; bits &= bits - 1) {
+        const uint32_t index = std::countr_zero(bits);
+        expected_income += this->board_.tile_probability[this->board_.ownables[index].tile] * this->state_.rent[index];
     }
     return expected_income;
 }
\ No newline at end of file
@@ -1,38 +1,27 @@
 #include "engine.h"
 #include "board.hpp"
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <set>
 #include <unordered_map>
 
 bool Engine::raise_fund(PlayerView& player, uint32_t owed) {
+    PhaseTimer timer(this->counters_.get(), Phase::RAISE_FUND);
     // Pay with cash first
     if (player.cash >= owed) {
         return true;
     }
 
     // Handle only non-mortgaged assets w/ no development
-    std::vector<PropertyView*> undeveloped_assets;
-    for (auto &p : this->properties_) {
-        if (p.owner_index == player.player_index && !p.hotel && p.houses == 0 && !p.mortgaged) {
-            undeveloped_assets.push_back(&p);
-        }
-    }
-
-    this->pay_by_mortgage(player, undeveloped_assets, owed);
+    const uint32_t owned = this->state_.owned_by(player.player_index);
+    this->pay_by_mortgage(player, owned & ~this->state_.developed_mask & ~this->state_.mortgaged_mask, owed);
     if (player.cash >= owed) {
         return true;
     }
 
-    std::vector<PropertyView*> developed_assets;
-    for (auto &p : this->properties_) {
-        if (p.owner_index == player.player_index && p.type == PropertyType::PROPERTY) {
-            if (p.houses > 0 || p.hotel) {
-                developed_assets.push_back(&p);
-            }
-        }
-    }
     // loop through pay by mortgage whenever monopoly frees up???
-    this->pay_by_houses(player, developed_assets, owed);
+    this->pay_by_houses(player, this->state_.developed_by(player.player_index) & this->board_.street_mask, owed);
     if (player.cash >= owed) {
         return true;
     }
@@ -40,83 +29,70 @@ bool Engine::raise_fund(PlayerView& player, uint32_t owed) {
 }
 
 // Future: probably split each property types impact eval into separate fns
-void Engine::pay_by_mortgage(PlayerView& player, std::vector<PropertyView*> undeveloped_assets, uint32_t amount) {
+void Engine::pay_by_mortgage(PlayerView& player, uint32_t undeveloped_assets, uint32_t amount) {
     // assumption: undeveloped assets are railroads / utilities / properties w/ no houses + not mortgaged
     while (amount > player.cash) {
-        PropertyView* lowest_impact_asset = nullptr;
+        int lowest_impact_asset = -1;
         double lowest_impact = std::numeric_limits<double>::infinity();
 
-        for (auto it = undeveloped_assets.begin(); it != undeveloped_assets.end();) {
-            PropertyView* asset = *it;
-            if (asset->mortgaged) {
-                it = undeveloped_assets.erase(it);
+        for (uint32_t bits = undeveloped_assets; bits; bits &= bits - 1) {
+            const uint32_t asset = std::countr_zero(bits);
+            if (this->state_.is_mortgaged(asset)) {
+                undeveloped_assets &= ~(1u << asset);
                 continue;
             }
+            const OwnableInfo& asset_info = this->board_.ownables[asset];
 
             double impact = 0;
-            switch (asset->type) {
-            case (PropertyType::PROPERTY): {
-                const PropertyInfo* asset_info = this->board_.propertyByTile(asset->position);
-                assert(asset_info);
-
-                if (is_monopoly(asset_info, true)) {
-                    const ColourGroup group = this->board_.tilesOfColour(asset_info->colour);
+            switch (asset_info.type) {
+            case (TileType::Property): {
+                if (this->state_.is_monopoly(asset_info.colour, true)) {
+                    const ColourGroup group = this->board_.tilesOfColour(asset_info.colour);
                     bool mortgage_ineligible = false;
 
                     for (uint8_t j = 0; j < group.count; j++) {
-                        int index = this->position_to_properties_[group.tiles[j]];
-                        if (this->properties_[index].houses > 0) {
+                        int index = this->board_.ownableByTile(group.tiles[j]);
+                        if (this->state_.houses[index] > 0) {
                             mortgage_ineligible = true;
                             break;
                         } else {
-                            if (group.tiles[j] != asset->position) {
+                            if (group.tiles[j] != asset_info.tile) {
                                 // Affected monopolies
                                 const PropertyInfo& affected_asset_info = *this->board_.propertyByTile(group.tiles[j]);
                                 impact += this->board_.tile_probability[group.tiles[j]] 
                                     * (static_cast<double>(affected_asset_info.rent[0]));
                             } else {
                                 // Actual mortgaged property
-                                assert(group.tiles[j] == asset->position);
-                                impact += this->board_.tile_probability[group.tiles[j]] * asset->current_rent;
+                                assert(group.tiles[j] == asset_info.tile);
+                                impact += this->board_.tile_probability[group.tiles[j]] * this->state_.rent[asset];
                             }
                         }
                     }
 
                     if (mortgage_ineligible) {
-                        it = undeveloped_assets.erase(it);
+                        undeveloped_assets &= ~(1u << asset);
                         continue;
                     }
                 } else {
-                    impact = this->board_.tile_probability[asset->position] * asset->current_rent;
+                    impact = this->board_.tile_probability[asset_info.tile] * this->state_.rent[asset];
                 }
                 break;
             }
-            case (PropertyType::RAILROAD): {
+            case (TileType::Railroad): {
                 const auto& rent_info = this->board_.railroads[0].rent;
-                int railroads_active = 0;
-                for (auto position : this->board_.railroad_positions) {
-                    int index = this->position_to_properties_[position];
-                    const PropertyView& railroad = this->properties_[index];
-                    if (railroad.owner_index == player.player_index && !railroad.mortgaged) {
-                        railroads_active++;
-                    }
-                }
+                int railroads_active = this->state_.railroads_active[player.player_index];
                 assert(railroads_active >= 1);
 
-                int current_rent = static_cast<int>(asset->current_rent);
+                int current_rent = static_cast<int>(this->state_.rent[asset]);
                 // new rent for remaining non-mortgaged railroads
                 int new_rent = (railroads_active > 1) ? rent_info[railroads_active - 2] : 0;
 
-                for (auto position : this->board_.railroad_positions) {
-                    int index = this->position_to_properties_[position];
-                    PropertyView& railroad = this->properties_[index];
-                    if (railroad.owner_index != player.player_index || railroad.mortgaged) {
-                        continue;
-                    }
-
-                    double prob = this->board_.tile_probability[railroad.position];
+                const uint32_t active = this->state_.owned_by(player.player_index) & this->board_.railroad_mask & ~this->state_.mortgaged_mask;
+                for (uint32_t railroads = active; railroads; railroads &= railroads - 1) {
+                    const uint32_t railroad = std::countr_zero(railroads);
+                    double prob = this->board_.tile_probability[this->board_.ownables[railroad].tile];
 
-                    if (railroad.property_id == asset->property_id) {
+                    if (railroad == asset) {
                         // mortgaged one: rent -> 0
                         impact += prob * current_rent;
                     } else {
@@ -126,47 +102,38 @@ void Engine::pay_by_mortgage(PlayerView& player, std::vector<PropertyView*> unde
                 }
                 break;
             }
-            case (PropertyType::UTILITY): {
+            case (TileType::Utility): {
                 const auto& multipliers = this->board_.utilities[0].multiplier;
-                int utilities_active = 0;
-                for (auto position : this->board_.utility_positions) {
-                    int index = this->position_to_properties_[position];
-                    const PropertyView& utility = this->properties_[index];
-                    if (utility.owner_index == player.player_index && !utility.mortgaged) {
-                        utilities_active++;
-                    }
-                }
+                int utilities_active = this->state_.utilities_active[player.player_index];
                 assert(utilities_active >= 1);
 
                 const double average_roll = 7.0;
                 int current_multiplier = multipliers[utilities_active - 1];
                 int new_multiplier = (utilities_active > 1) ? multipliers[utilities_active - 2] : 0;
 
-                for (auto position : this->board_.utility_positions) {
-                    int index = this->position_to_properties_[position];
-                    const PropertyView& utility = this->properties_[index];
-                    if (utility.owner_index != player.player_index || utility.mortgaged) {
-                        continue;
-                    }
-
-                    double prob = this->board_.tile_probability[position];
+                const uint32_t active = this->state_.owned_by(player.player_index) & this->board_.utility_mask & ~this->state_.mortgaged_mask;
+                for (uint32_t utilities = active; utilities; utilities &= utilities - 1) {
+                    const uint32_t utility = std::countr_zero(utilities);
+                    double prob = this->board_.tile_probability[this->board_.ownables[utility].tile];
 
-                    if (utility.property_id == asset->property_id) {
+                    if (utility == asset) {
                         impact += prob * current_multiplier * average_roll;
                     } else {
                         impact += prob * (current_multiplier - new_multiplier) * average_roll;
                     }
                 }
                 break;
-            }}
+            }
+            default:
+                break;
+            }
             if (impact < lowest_impact) {
                 lowest_impact = impact;
-                lowest_impact_asset = asset;
+                lowest_impact_asset = static_cast<int>(asset);
             }
-            it++;
         }
         // has found least impactful asset (if any)
-        if (lowest_impact_asset) {
+        if (lowest_impact_asset >= 0) {
             this->mortgage(player, lowest_impact_asset);
             if (player.cash >= amount) {
                 return;
@@ -178,58 +145,52 @@ void Engine::pay_by_mortgage(PlayerView& player, std::vector<PropertyView*> unde
     return;
 }
 
-void Engine::pay_by_houses(PlayerView& player, std::vector<PropertyView*> developed_assets, uint32_t amount) {
+void Engine::pay_by_houses(PlayerView& player, uint32_t developed_assets, uint32_t amount) {
     std::set<Colour> monopolies;
-    for (auto* asset : developed_assets) {
-        monopolies.insert(static_cast<Colour>(asset->colour_id));
+    for (uint32_t bits = developed_assets; bits; bits &= bits - 1) {
+        monopolies.insert(this->board_.ownables[std::countr_zero(bits)].colour);
     }
 
     while (amount > player.cash) {
         std::unordered_map<Colour, uint8_t> max_houses;
         for (auto colour : monopolies) {
-            const ColourGroup& group = this->board_.tilesOfColour(colour);
-            for (int i = 0; i < group.count; i++) {
-                int index = this->position_to_properties_[group.tiles[i]];
-                PropertyView* property = &this->properties_[index];
-                assert(property->type == PropertyType::PROPERTY);
-                assert(property->owner_index == player.player_index);
-                max_houses[group.colour] = std::max(max_houses[group.colour], property->houses);
-                if (property->hotel) {
-                    max_houses[group.colour] = 5;
-                }
+            for (uint32_t bits = this->board_.colourMask(colour); bits; bits &= bits - 1) {
+                const uint32_t index = std::countr_zero(bits);
+                assert(this->state_.owner_of(index) == player.player_index);
+                max_houses[colour] = std::max(max_houses[colour], this->state_.houses[index]);
             }
         }
 
-        PropertyView* lowest_impact_asset = nullptr;
+        int lowest_impact_asset = -1;
         double lowest_impact = std::numeric_limits<double>::infinity();
         int lowest_impact_house_count = 0;
 
-        for (auto* asset : developed_assets) {
-            if (asset->houses == 0) {
+        for (uint32_t bits = developed_assets; bits; bits &= bits - 1) {
+            const uint32_t asset = std::countr_zero(bits);
+            const OwnableInfo& asset_ownable = this->board_.ownables[asset];
+            const uint8_t asset_houses = this->state_.houses[asset];
+            if (asset_houses == 0) {
                 continue;
             }
-            int house_count = max_houses[static_cast<Colour>(asset->colour_id)];
-            if (house_count > asset->houses || (house_count == 5 && !asset->hotel)) {
+            // hotels count as 5, so this also skips houses next to a hotel
+            int house_count = max_houses[asset_ownable.colour];
+            if (house_count > asset_houses) {
                 continue;
             }
-            assert(asset->houses > 0);
 
-            double tile_probability = this->board_.tile_probability[asset->position];
+            double tile_probability = this->board_.tile_probability[asset_ownable.tile];
             double money_raised = 0;
             double impact = 0;
 
-            if (asset->hotel && this->state_.houses_remaining < 4) {
+            if (asset_houses == GameState::HOTEL && this->state_.houses_remaining < 4) {
                 int houses_available = this->state_.houses_remaining;
-                auto it = monopolies.find(static_cast<Colour>(asset->colour_id));
-                assert(it != monopolies.end());
-                Colour colour = *it;
-                const ColourGroup& group = this->board_.tilesOfColour(colour);
+                assert(monopolies.count(asset_ownable.colour));
+                const ColourGroup& group = this->board_.tilesOfColour(asset_ownable.colour);
                 for (int i = 0; i < group.count; i++) {
-                    int index = this->position_to_properties_[group.tiles[i]];
-                    PropertyView& property = this->properties_[index];
-                    if (!property.hotel) {
-                        assert(property.houses == 4);
-                        houses_available += property.houses;
+                    int index = this->board_.ownableByTile(group.tiles[i]);
+                    if (!this->state_.has_hotel(index)) {
+                        assert(this->state_.houses[index] == 4);
+                        houses_available += this->state_.houses[index];
                     }
                 }
 
@@ -243,11 +204,11 @@ void Engine::pay_by_houses(PlayerView& player, std::vector<PropertyView*> develo
                     if (houses_available < (i + 1) * max_houses) {
                         num_houses = max_houses - 1;
                     }
-                    int index = this->position_to_properties_[group.tiles[i]];
-                    PropertyView& asset = this->properties_[index];
+                    int index = this->board_.ownableByTile(group.tiles[i]);
+                    const uint8_t houses = this->state_.houses[index];
                     const PropertyInfo& asset_info = *this->board_.propertyByTile(group.tiles[i]);
-                    double rent_diff = asset_info.rent[asset.houses] - asset_info.rent[num_houses];
-                    double income = static_cast<double>((asset.houses - num_houses) * asset_info.house_cost) / 2;
+                    double rent_diff = asset_info.rent[houses] - asset_info.rent[num_houses];
+                    double income = static_cast<double>((houses - num_houses) * asset_info.house_cost) / 2;
                     money_raised += income;
                     
                     total_rent_lost += this->board_.tile_probability[group.tiles[i]] * rent_diff;
@@ -256,20 +217,20 @@ void Engine::pay_by_houses(PlayerView& player, std::vector<PropertyView*> develo
                 }
                 impact = total_rent_lost / total_raised;
             } else {
-                const PropertyInfo& asset_info = *this->board_.propertyByTile(asset->position);
-                assert(asset->current_rent == asset_info.rent[asset->houses]);
-                double rent_diff = asset_info.rent[asset->houses] - asset_info.rent[asset->houses - 1];
-                money_raised = static_cast<double>(asset->house_price) / 2;
+                const PropertyInfo& asset_info = *this->board_.propertyByTile(asset_ownable.tile);
+                assert(this->state_.rent[asset] == asset_info.rent[asset_houses]);
+                double rent_diff = asset_info.rent[asset_houses] - asset_info.rent[asset_houses - 1];
+                money_raised = static_cast<double>(asset_ownable.house_cost) / 2;
                 impact = tile_probability * rent_diff / money_raised;
             }
 
             if (impact < lowest_impact) {
                 lowest_impact = impact;
-                lowest_impact_asset = asset;
+                lowest_impact_asset = static_cast<int>(asset);
             }
         }
         
-        if (lowest_impact_asset) {
+        if (lowest_impact_asset >= 0) {
             this->sell_house(player, lowest_impact_asset);
             if (player.cash >= amount) {
                 return;
@@ -279,17 +240,10 @@ void Engine::pay_by_houses(PlayerView& player, std::vector<PropertyView*> develo
         }
 
         if (!developed_monopoly(lowest_impact_asset)) {
-            monopolies.erase(static_cast<Colour>(lowest_impact_asset->colour_id));
-
-            ColourGroup group = this->board_.tilesOfColour(static_cast<Colour>(lowest_impact_asset->colour_id));
-            std::vector<PropertyView*> newly_undeveloped_assets;
-            for (int i = 0; i < group.count; i++) {
-                int index = this->position_to_properties_[group.tiles[i]];
-                PropertyView* p = &this->properties_[index];
-                assert(p->houses == 0);
-                newly_undeveloped_assets.push_back(p);
-            }
-            this->pay_by_mortgage(player, newly_undeveloped_assets, amount);
+            const Colour colour = this->board_.ownables[lowest_impact_asset].colour;
+            monopolies.erase(colour);
+            assert((this->state_.developed_mask & this->board_.colourMask(colour)) == 0);
+            this->pay_by_mortgage(player, this->board_.colourMask(colour), amount);
             if (player.cash >= amount) {
                 return;
             }
@@ -298,220 +252,134 @@ void Engine::pay_by_houses(PlayerView& player, std::vector<PropertyView*> develo
     return;
 }
 
-void Engine::unmortgage(PlayerView& player, PropertyView* property) {
-    uint32_t unmortgage_cost = static_cast<uint32_t>((property->purchase_price / 2) * 1.1);
-    assert(property->mortgaged);
-    assert(property->owner_index == player.player_index);
+void Engine::unmortgage(PlayerView& player, uint32_t index) {
+    const OwnableInfo& info = this->board_.ownables[index];
+    uint32_t unmortgage_cost = static_cast<uint32_t>((info.purchase_price / 2) * 1.1);
+    assert(this->state_.is_mortgaged(index));
+    assert(this->state_.owner_of(index) == player.player_index);
     assert(player.cash >= unmortgage_cost);
-    assert(property->houses == 0);
+    assert(this->state_.houses[index] == 0);
 
     player.cash -= unmortgage_cost;
-    property->mortgaged = false;
-
-    switch (property->type) {
-    case (PropertyType::PROPERTY): {
-        const PropertyInfo* property_info = this->board_.propertyByTile(property->position);
-        if (is_monopoly(property_info, true)) {
-            const ColourGroup group = this->board_.tilesOfColour(property_info->colour);
-            for (int i = 0; i < group.count; i++) {
-                int index = this->position_to_properties_[group.tiles[i]];
-                PropertyView& p = this->properties_[index];
-                assert(p.owner_index == player.player_index);
-                if (p.houses == 0) {
-                    p.current_rent = p.rent0 * 2;
+    this->state_.set_mortgaged(index, false);
+
+    switch (info.type) {
+    case (TileType::Property): {
+        if (this->state_.is_monopoly(info.colour, true)) {
+            for (uint32_t bits = this->board_.colourMask(info.colour); bits; bits &= bits - 1) {
+                const uint32_t p = std::countr_zero(bits);
+                assert(this->state_.owner_of(p) == player.player_index);
+                if (this->state_.houses[p] == 0) {
+                    this->state_.set_rent(p, this->board_.propertyByTile(this->board_.ownables[p].tile)->rent[0] * 2);
                 }
             }
         }
     }
-    case (PropertyType::RAILROAD): {
-        int railroads_active = 0;
-        for (auto position : this->board_.railroad_positions) {
-            int index = this->position_to_properties_[position];
-            const PropertyView& railroad = this->properties_[index];
-            if (railroad.owner_index == player.player_index && !railroad.mortgaged) {
-                railroads_active++;
-            }
-        }
-        assert(railroads_active >= 1);
-
-        const auto& rent_info = this->board_.railroads[0].rent;
-        for (auto position : this->board_.railroad_positions) {
-            int index = this->position_to_properties_[position];
-            PropertyView& railroad = this->properties_[index];
-            if (railroad.owner_index == player.player_index) {
-                railroad.current_rent = rent_info[railroads_active - 1];
-            }
-        }
+    case (TileType::Railroad):
+        assert(this->state_.railroads_active[player.player_index] >= 1);
+        this->refresh_railroad_rents(player.player_index, true);
         break;
-    }
-    case (PropertyType::UTILITY): {
-        int utilities_active = 0;
-        for (auto position : this->board_.utility_positions) {
-            int index = this->position_to_properties_[position];
-            const PropertyView& utility = this->properties_[index];
-            if (utility.owner_index == player.player_index && !utility.mortgaged) {
-                utilities_active++;
-            }
-        }
-        assert(utilities_active >= 1);
-
-        const double average_roll = 7.0;
-        const auto& multipliers = this->board_.utilities[0].multiplier;
-        for (auto position : this->board_.utility_positions) {
-            int index = this->position_to_properties_[position];
-            PropertyView& utility = this->properties_[index];
-            if (utility.owner_index == player.player_index) {
-                utility.current_rent = average_roll * multipliers[utilities_active - 1];
-            }
-        }
+    case (TileType::Utility):
+        assert(this->state_.utilities_active[player.player_index] >= 1);
+        this->refresh_utility_rents(player.player_index);
+        break;
+    default:
         break;
-    }
     }
 }
 
-void Engine::mortgage(PlayerView& player, PropertyView* property) {
-    assert(!property->mortgaged);
-    assert(property->owner_index == player.player_index);
-    switch (property->type)
+void Engine::mortgage(PlayerView& player, uint32_t index) {
+    const OwnableInfo& info = this->board_.ownables[index];
+    assert(!this->state_.is_mortgaged(index));
+    assert(this->state_.owner_of(index) == player.player_index);
+    switch (info.type)
     {
-    case (PropertyType::PROPERTY): {
-        assert(!property->hotel);
-        assert(property->houses == 0);
-        const PropertyInfo* asset_info = this->board_.propertyByTile(property->position);
-        if (is_monopoly(asset_info, true)) {
-            const ColourGroup group = this->board_.tilesOfColour(asset_info->colour);
-            for (int i = 0; i < group.count; i++) {
-                int index = this->position_to_properties_[group.tiles[i]];
-                PropertyView& p = this->properties_[index];
-                assert(p.owner_index == player.player_index);
-                if (p.property_id == property->property_id) {
+    case (TileType::Property): {
+        assert(this->state_.houses[index] == 0);
+        if (this->state_.is_monopoly(info.colour, true)) {
+            for (uint32_t bits = this->board_.colourMask(info.colour); bits; bits &= bits - 1) {
+                const uint32_t p = std::countr_zero(bits);
+                assert(this->state_.owner_of(p) == player.player_index);
+                if (p == index) {
                     // property to be mortgaged
-                    p.mortgaged = true;
-                    p.current_rent = 0;
+                    this->state_.set_mortgaged(p, true);
+                    this->state_.set_rent(p, 0);
                 } else {
-                    p.current_rent = p.rent0;
+                    this->state_.set_rent(p, this->board_.propertyByTile(this->board_.ownables[p].tile)->rent[0]);
                 }
             }
         } else {
-            property->mortgaged = true;
-            property->current_rent = 0;
+            this->state_.set_mortgaged(index, true);
+            this->state_.set_rent(index, 0);
         }
         break;
     }
-    case (PropertyType::RAILROAD): {
-        int railroads_active = 0;
-        for (auto position : this->board_.railroad_positions) {
-            int index = this->position_to_properties_[position];
-            const PropertyView& railroad = this->properties_[index];
-            if (railroad.owner_index == player.player_index && !railroad.mortgaged) {
-                railroads_active++;
-            }
-        }
+    case (TileType::Railroad): {
+        int railroads_active = this->state_.railroads_active[player.player_index];
         assert(railroads_active >= 1);
 
         const auto& rent_info = this->board_.railroads[0].rent;
-        for (auto position : this->board_.railroad_positions) {
-            int index = this->position_to_properties_[position];
-            PropertyView& railroad = this->properties_[index];
-            if (railroad.property_id == property->property_id) {
-                railroad.mortgaged = true;
-                railroad.current_rent = 0;
-            } else if (railroad.owner_index == player.player_index && !railroad.mortgaged) {
+        for (uint32_t bits = this->state_.owned_by(player.player_index) & this->board_.railroad_mask; bits; bits &= bits - 1) {
+            const uint32_t railroad = std::countr_zero(bits);
+            if (railroad == index) {
+                this->state_.set_mortgaged(railroad, true);
+                this->state_.set_rent(railroad, 0);
+            } else if (!this->state_.is_mortgaged(railroad)) {
                 assert(railroads_active >= 2);
-                railroad.current_rent = rent_info[railroads_active - 2];
+                this->state_.set_rent(railroad, rent_info[railroads_active - 2]);
             }
         }
         break;
     }
-    case (PropertyType::UTILITY): {
-        int utilities_active = 0;
-        for (auto position : this->board_.utility_positions) {
-            int index = this->position_to_properties_[position];
-            const PropertyView& utility = this->properties_[index];
-            if (utility.owner_index == player.player_index && !utility.mortgaged) {
-                utilities_active++;
-            }
-        }
+    case (TileType::Utility): {
+        int utilities_active = this->state_.utilities_active[player.player_index];
         assert(utilities_active >= 1);
 
         const double average_roll = 7.0;
         const auto& multipliers = this->board_.utilities[0].multiplier;
-        for (auto position : this->board_.utility_positions) {
-            int index = this->position_to_properties_[position];
-            PropertyView& utility = this->properties_[index];
-            if (utility.property_id == property->property_id) {
-                utility.mortgaged = true;
-                utility.current_rent = 0;
-            } else if (utility.owner_index == player.player_index && !utility.mortgaged) {
+        for (uint32_t bits = this->state_.owned_by(player.player_index) & this->board_.utility_mask; bits; bits &= bits - 1) {
+            const uint32_t utility = std::countr_zero(bits);
+            if (utility == index) {
+                this->state_.set_mortgaged(utility, true);
+                this->state_.set_rent(utility, 0);
+            } else if (!this->state_.is_mortgaged(utility)) {
                 assert(utilities_active >= 2);
-                utility.current_rent = average_roll * multipliers[utilities_active - 2];
+                this->state_.set_rent(utility, static_cast<int32_t>(average_roll * multipliers[utilities_active - 2]));
             }
         }
         break;
-    }}
-    player.cash += property->purchase_price / 2;
+    }
+    default:
+        break;
+    }
+    player.cash += info.purchase_price / 2;
     return;
 }
 
-void Engine::auction(PropertyView* property) {
-    assert(property->houses == 0);
-    assert(property);
-    property->owner_index = -1;
-    property->is_owned = false;
+void Engine::auction(uint32_t index) {
+    PhaseTimer timer(this->counters_.get(), Phase::AUCTION);
+    assert(this->state_.houses[index] == 0);
+    this->state_.set_owner(index, GameState::NO_OWNER);
     while (true) {
-        int index = this->position_to_properties_[property->position];
-        assert(index >= 0);
-        AuctionView auction = {
-            static_cast<uint32_t>(index),
-            0u
-        };
-        int highest_bidder = -1;
-
-        // Bidding loop
-        while (true) {
-            bool raised_this_round = false;
-
-            for (int i = 0; i < static_cast<int>(this->agent_adapters_.size()); i++) {
-                if (this->players_[i].retired) {
-                    continue;
-                }
-
-                this->state_.current_player_index = this->players_[i].player_index;
-                Action action = this->agent_adapters_[i].auction(&this->state_, &auction);
-                if (action.type != ACTION_AUCTION_BID) {
-                    this->penalize(this->players_[i], "non-bid response");
-                    continue;
-                }
-
-                uint32_t bid = action.auction_bid;
-                if (bid <= auction.current_bid) {
-                    continue;
-                }
-
-                auction.current_bid = bid;
-                highest_bidder = static_cast<int>(i);
-                raised_this_round = true;
-            }
-
-            if (!raised_this_round) {
-                break;
-            }
-        }
-
-        if (highest_bidder < 0 || auction.current_bid == 0) {
-            property->mortgaged = false;
-            property->current_rent = 0;
+        uint32_t price = 0;
+        const int highest_bidder = this->state_.auction_mode == AuctionMode::PROXY
+            ? this->proxy_bidding(index, price)
+            : this->bidding_rounds(index, price);
+
+        if (highest_bidder < 0 || price == 0) {
+            this->state_.set_mortgaged(index, false);
+            this->state_.set_rent(index, 0);
             return;
         }
 
-        PlayerView& winner = this->players_[highest_bidder];
+        PlayerView& winner = this->state_.players[highest_bidder];
 
-        bool can_pay = this->raise_fund(winner, auction.current_bid);
+        bool can_pay = this->raise_fund(winner, price);
         if (!can_pay) {
             this->bankrupt(winner, nullptr);
 
             bool any_active = false;
-            for (auto const& p : this->players_) {
+            for (auto const& p : this->state_.seated_players()) {
                 if (!p.retired) {
                     any_active = true;
                     break;
@@ -523,15 +391,91 @@ void Engine::auction(PropertyView* property) {
             continue;
         }
 
-        assert(winner.cash >= auction.current_bid);
-        winner.cash -= auction.current_bid;
-        property->owner_index = highest_bidder;
-        property->is_owned = true;
-        this->update_rent(*property);
+        assert(winner.cash >= price);
+        winner.cash -= price;
+        this->state_.set_owner(index, highest_bidder);
+        this->update_rent(index);
         return;
     }
 }
 
+int Engine::bidding_rounds(uint32_t index, uint32_t& price) {
+    AuctionView auction = {
+        index,
+        0u
+    };
+    int highest_bidder = -1;
+
+    // Bidding loop
+    while (true) {
+        bool raised_this_round = false;
+
+        for (int i = 0; i < static_cast<int>(this->state_.num_players); i++) {
+            if (this->state_.players[i].retired) {
+                continue;
+            }
+
+            Action action = this->ask_auction(this->state_.players[i].player_index, auction);
+            if (action.type != ACTION_AUCTION_BID) {
+                this->penalize(this->state_.players[i], "non-bid response");
+                continue;
+            }
+
+            uint32_t bid = action.auction_bid;
+            if (bid <= auction.current_bid) {
+                continue;
+            }
+
+            auction.current_bid = bid;
+            highest_bidder = static_cast<int>(i);
+            raised_this_round = true;
+        }
+
+        if (!raised_this_round) {
+            break;
+        }
+    }
+    price = auction.current_bid;
+    return highest_bidder;
+}
+
+// One ask per player for the most they would pay. As if the price went up by the increment until
+// all but one dropped out: the top bid wins at the second one plus the increment, capped at the
+// top bid, and ties go to the earlier seat.
+int Engine::proxy_bidding(uint32_t index, uint32_t& price) {
+    const AuctionView auction = {
+        index,
+        0u,
+        true
+    };
+    int highest_bidder = -1;
+    uint32_t highest = 0;
+    uint32_t second = 0;
+
+    for (int i = 0; i < static_cast<int>(this->state_.num_players); i++) {
+        if (this->state_.players[i].retired) {
+            continue;
+        }
+
+        Action action = this->ask_auction(this->state_.players[i].player_index, auction);
+        if (action.type != ACTION_AUCTION_BID) {
+            this->penalize(this->state_.players[i], "non-bid response");
+            continue;
+        }
+
+        const uint32_t bid = action.auction_bid;
+        if (bid > highest) {
+            second = highest;
+            highest = bid;
+            highest_bidder = i;
+        } else if (bid > second) {
+            second = bid;
+        }
+    }
+    price = static_cast<uint32_t>(std::min<uint64_t>(highest, uint64_t{second} + this->state_.auction_increment));
+    return highest_bidder;
+}
+
 void Engine::bankrupt(PlayerView& player, PlayerView* debtor) {
     if (debtor) {
         debtor->cash += player.cash;
@@ -555,20 +499,13 @@ void Engine::bankrupt(PlayerView& player, PlayerView* debtor) {
     player.previous_offer = {};
     player.offer_accepted = false;
 
-    std::vector<PropertyView*> assets{};
-    for (auto& property : this->properties_) {
-        if (property.owner_index == player.player_index) {
-            assets.push_back(&property);
-        }
-    }
-
-    if (debtor) {
-        for (auto* asset : assets) {
-            asset->owner_index = debtor->player_index;
-            this->update_rent(*asset);
-        }
-    } else {
-        for (auto* asset: assets) {
+    const uint32_t assets = this->state_.owned_by(player.player_index);
+    for (uint32_t bits = assets; bits; bits &= bits - 1) {
+        const uint32_t asset = std::countr_zero(bits);
+        if (debtor) {
+            this->state_.set_owner(asset, debtor->player_index);
+            this->update_rent(asset);
+        } else {
             this->auction(asset);
         }
     }
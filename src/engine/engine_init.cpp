@@ -1,165 +1,152 @@
 #include "engine.h"
+#include "agent_pool.h"
 #include "board.hpp"
-#include <numeric>
-#include <iostream>
+#include "replay_log.h"
+#include "log.h"
+#include <stdexcept>
+
+namespace {
+// Routes engine decisions to the game's agent plugins through a view of the live state
+class AgentPolicy : public Policy {
+public:
+    explicit AgentPolicy(std::vector<AgentAdapter>& agents) : agents_(agents) {}
+
+    Action agent_turn(const GameState& state, uint32_t player_index) override {
+        GameStateView view = state.view();
+        return agents_[player_index].agent_turn(&view);
+    }
+
+    Action auction(const GameState& state, uint32_t player_index, const AuctionView& auction) override {
+        GameStateView view = state.view();
+        return agents_[player_index].auction(&view, &auction);
+    }
+
+    Action trade_offer(const GameState& state, uint32_t player_index, const TradeOffer& offer) override {
+        GameStateView view = state.view();
+        return agents_[player_index].trade_offer(&view, &offer);
+    }
+
+private:
+    std::vector<AgentAdapter>& agents_;
+};
+}
 
-Engine::Engine(GameConfig config) : cfg_(std::move(config)), rng_(cfg_.seed), dice_(1, 6), board_(board()) {
+Engine::Engine(GameConfig config, AgentPool* pool) : cfg_(std::move(config)), pool_(pool), board_(board()) {
+    if (cfg_.agent_specs.size() > GameState::MAX_PLAYERS) {
+        throw std::runtime_error("too many agents, at most " + std::to_string(GameState::MAX_PLAYERS));
+    }
     // Reserve space on agent_adapters_, mildly improves performance
-    std::cerr << "Engine init start\n";
-    std::cerr << "Agent adapters setup\n";
-    std::cerr << "Agent adapters allocation\n";
+    LOG(DEBUG, "Game ", cfg_.game_id, " init, ", cfg_.agent_specs.size(), " agents");
     agent_adapters_.reserve(cfg_.agent_specs.size());
-    std::cerr << "Agent adapters creation\n";
     // Loop through specs and create the corresponding adapters
     for (const auto& spec : cfg_.agent_specs) {
         // Emplace_back calls constructor and creates the AgentAdapter
-        agent_adapters_.emplace_back(spec);
+        if (pool_) {
+            agent_adapters_.emplace_back(pool_->acquire(spec));
+        } else {
+            agent_adapters_.emplace_back(spec);
+        }
     }
 
-    penalties_.assign(cfg_.agent_specs.size(), 0);
-    std::cerr << "Notify agent of game start\n";
     for (size_t i = 0; i < agent_adapters_.size(); i++) {
         // Apparently generates a random seed
-        const uint64_t seed = cfg_.seed ^ (static_cast<uint64_t>(i) + 0x9e3779b97f4a7c15ULL);
+        const uint64_t seed = cfg_.rng == RngBackend::XOSHIRO256
+            ? derive_seed(cfg_.seed, i + 1)
+            : cfg_.seed ^ (static_cast<uint64_t>(i) + 0x9e3779b97f4a7c15ULL);
         agent_adapters_[i].game_start(i, seed);
-        penalties_[i] = 0;
+        agent_adapters_[i].time_calls(cfg_.collect_stats);
+        agent_adapters_[i].set_budget(cfg_.budget);
     }
 
-    init_setup();
-    std::cerr << "Engine init complete\n";
-}
-
-void Engine::init_setup() {
-    // Maybe should be in config.json, but not needed rn
-    static constexpr uint32_t STARTING_CASH = 1500;
-    static constexpr uint32_t START_POSITION = 0;
-    static constexpr uint32_t NUM_PROPERTIES = 28;
-    static constexpr uint32_t NUM_TILES = 40;
-
-    const uint32_t player_count = static_cast<uint64_t>(cfg_.agent_specs.size());
-
-    memset(&state_, 0, sizeof(state_));
-
-    state_.game_id = cfg_.seed;
-    state_.players_remaining = player_count;
-    state_.num_properties = NUM_PROPERTIES;
-    state_.houses_remaining = 32;
-    state_.hotels_remaining = 12;
-    // To get player info with player_index i, its players_[i]
-    // Initialize player state
-    players_.assign(player_count, {});
-    for (uint32_t i = 0; i < player_count; i++) {
-        
-        auto& player = players_[i];
-        player.player_index = i;
-        player.cash = STARTING_CASH;
-        player.position = 0;
-        player.retired = false;
-
-        player.previous_offer = {};
-        player.trades_offered = 0;
-        player.offer_accepted = false;
-
-        player.in_jail = false;
-        player.turns_in_jail = 0;
-        player.jail_free_cards = 0;
-        player.double_rolls = 0;
-        player.jail_rolled_this_turn = false;
-
-        player.railroads_owned = 0;
-        player.utilities_owned = 0;
+    if (cfg_.collect_stats) {
+        counters_ = std::make_unique<PhaseCounters>();
     }
-
-    auto& b = this->board_;
-
-    properties_.assign(NUM_PROPERTIES, {});
-    position_to_properties_.assign(NUM_TILES, -1);
-    int property_count = 0;
-    for (uint32_t i = 0; i < NUM_TILES; i++) {
-        const TileType tile_type = b.tiles[i].type;
-        switch (tile_type) {
-        case TileType::Property: {
-            const PropertyInfo* property = b.propertyByTile(i);
-            auto& street = properties_[property_count];
-            street.position = i;
-            street.property_id = property->property_id;
-            street.owner_index = -1;
-            street.is_owned = false;
-            street.mortgaged = false;
-
-            street.type = PropertyType::PROPERTY;
-            street.colour_id = static_cast<uint8_t>(property->colour);
-            street.house_price = property->house_cost;
-            street.houses = 0;
-            street.hotel = false;
-
-            street.auctioned_this_turn = false;
-            street.is_monopoly = false;
-
-            street.purchase_price = property->purchase_price;
-            auto& rent_values = property->rent;
-            std::tie(street.rent0, street.rent1, street.rent2, street.rent3, street.rent4, street.rentH) =
-                std::make_tuple(rent_values[0], rent_values[1], rent_values[2], rent_values[3], rent_values[4], rent_values[5]);
-            
-            street.current_rent = 0;
-            position_to_properties_[i] = property_count;
-            property_count++;
-            break;
+    agent_policy_ = std::make_unique<AgentPolicy>(agent_adapters_);
+    policy_ = agent_policy_.get();
+    state_ = GameState::initial(cfg_.seed, static_cast<uint32_t>(cfg_.agent_specs.size()), cfg_.max_turns, cfg_.reshuffle_decks, cfg_.rng);
+    state_.auction_mode = cfg_.auction_mode;
+    state_.auction_increment = cfg_.auction_increment;
+    if (!cfg_.log_path.empty()) {
+        ReplayHeader header = {cfg_.game_id, cfg_.seed, cfg_.max_turns, state_.num_players, cfg_.rng, cfg_.reshuffle_decks,
+                               cfg_.auction_mode, cfg_.auction_increment};
+        std::copy(state_.community_deck.cards.begin(), state_.community_deck.cards.end(), header.community_deck.begin());
+        std::copy(state_.chance_deck.cards.begin(), state_.chance_deck.cards.end(), header.chance_deck.begin());
+        for (const auto& spec : cfg_.agent_specs) {
+            header.agent_names.push_back(spec.name);
         }
-        case TileType::Railroad: {
-            const int railroad_id = b.railroadByTile(i);
-            const RailroadInfo* railroad = &b.railroads[railroad_id];
-            auto& rail = properties_[property_count];
-            rail.position = i;
-            rail.property_id = railroad->railroad_id;
-            rail.owner_index = -1;
-            rail.is_owned = false;
-            rail.mortgaged = false;
-
-            rail.auctioned_this_turn = false;
-
-            rail.type = PropertyType::RAILROAD;
-
-            rail.purchase_price = railroad->purchase_price;
-
-            rail.current_rent = 0;
-            position_to_properties_[i] = property_count;
-            property_count++;
-            break;
-        }
-        case TileType::Utility: {
-            const int utility_id = b.utilityByTile(i);
-            const UtilityInfo* utility = &b.utilities[utility_id];
-            auto& util = properties_[property_count];
-            util.position = i;
-            util.property_id = utility->utility_id;
-            util.owner_index = -1;
-            util.is_owned = false;
-            util.mortgaged = false;
+        recorder_ = std::make_unique<ReplayWriter>(header);
+    }
+    LOG(DEBUG, "Game ", cfg_.game_id, " init complete");
+}
 
-            util.auctioned_this_turn = false;
+Engine::Engine(const GameState& state, Policy& policy, ReplayReader* replay)
+    : cfg_{state.game_id, state.game_id, state.max_turns, {}, state.community_deck.reshuffle, state.rng.backend},
+      pool_(nullptr), board_(board()), policy_(&policy), state_(state), replay_(replay) {
+    this->state_.sync_properties();
+}
 
-            util.type = PropertyType::UTILITY;
+Engine::~Engine() {
+    if (!pool_) {
+        return;
+    }
+    for (size_t i = 0; i < agent_adapters_.size(); i++) {
+        pool_->release(cfg_.agent_specs[i], std::move(agent_adapters_[i]));
+    }
+}
 
-            util.purchase_price = utility->purchase_price;
+Action Engine::ask_turn(uint32_t player_index) {
+    this->state_.current_player_index = player_index;
+    this->state_.sync_properties();
+    Action action;
+    {
+        PhaseTimer timer(this->counters_.get(), Phase::AGENT_TURN);
+        action = this->policy_->agent_turn(this->state_, player_index);
+    }
+    if (this->recorder_) {
+        this->recorder_->decision(ReplayTag::TURN, action);
+    }
+    this->check_overrun(player_index);
+    return action;
+}
 
-            util.current_rent = 0;
-            position_to_properties_[i] = property_count;
-            property_count++;
-            break;
-        }
-        default:
-            break;
-        }
+void Engine::check_overrun(uint32_t player_index) {
+    const bool overran = this->replay_ ? this->replay_->overrun()
+        : !this->agent_adapters_.empty() && this->agent_adapters_[player_index].overran();
+    if (!overran) {
+        return;
     }
-    this->state_.players = this->players_.data();
-    this->state_.properties = this->properties_.data();
+    if (this->recorder_) {
+        this->recorder_->overrun();
+    }
+    this->penalize(this->state_.players[player_index], "decision over time budget");
+}
 
-    this->community_deck_.resize(16);
-    std::iota(this->community_deck_.begin(), this->community_deck_.end(), 0);
-    std::shuffle(this->community_deck_.begin(), this->community_deck_.end(), this->rng_);
+Action Engine::ask_auction(uint32_t player_index, const AuctionView& auction) {
+    this->state_.current_player_index = player_index;
+    this->state_.sync_properties();
+    Action action;
+    {
+        PhaseTimer timer(this->counters_.get(), Phase::AGENT_AUCTION);
+        action = this->policy_->auction(this->state_, player_index, auction);
+    }
+    if (this->recorder_) {
+        this->recorder_->decision(ReplayTag::AUCTION, action);
+    }
+    this->check_overrun(player_index);
+    return action;
+}
 
-    this->chance_deck_.resize(16);
-    std::iota(this->chance_deck_.begin(), this->chance_deck_.end(), 0);
-    std::shuffle(this->chance_deck_.begin(), this->chance_deck_.end(), this->rng_);
-}
\ No newline at end of file
+Action Engine::ask_trade(uint32_t player_index, const TradeOffer& offer) {
+    this->state_.current_player_index = player_index;
+    this->state_.sync_properties();
+    Action action;
+    {
+        PhaseTimer timer(this->counters_.get(), Phase::AGENT_TRADE);
+        action = this->policy_->trade_offer(this->state_, player_index, offer);
+    }
+    if (this->recorder_) {
+        this->recorder_->decision(ReplayTag::TRADE, action);
+    }
+    this->check_overrun(player_index);
+    return action;
+}
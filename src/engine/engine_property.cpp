@@ -1,141 +1,92 @@
 #include "engine.h"
 #include "board.hpp"
+#include <bit>
 #include <cassert>
 #include <iostream>
 
-void Engine::buy_property(PlayerView& player, PropertyView* property) {
-    assert(property->owner_index == -1);
-    bool payable = this->raise_fund(player, property->purchase_price);
+void Engine::buy_property(PlayerView& player, uint32_t index) {
+    const OwnableInfo& info = this->board_.ownables[index];
+    assert(!this->state_.is_owned(index));
+    bool payable = this->raise_fund(player, info.purchase_price);
     if (!payable) { 
         this->bankrupt(player, nullptr);
         return;
     } else {
-        player.cash -= property->purchase_price;
-        property->owner_index = player.player_index;
-        property->is_owned = true;
-        switch (property->type)
+        player.cash -= info.purchase_price;
+        this->state_.set_owner(index, player.player_index);
+        switch (info.type)
         {
-        case (PropertyType::PROPERTY): {
-            const PropertyInfo* property_info = this->board_.propertyByTile(property->position);
-            if (is_monopoly(property_info, true)) {
-                ColourGroup group = this->board_.tilesOfColour(property_info->colour);
-                for (int i = 0; i < group.count; i++) {
-                    int index = this->position_to_properties_[group.tiles[i]];
-                    PropertyView* p = &this->properties_[index];
-                    p->is_monopoly = true;
-                    if (p->houses == 0) {
-                        p->current_rent = p->rent0 * 2;
-                    }
-                }
-            } else {
-                property->current_rent = property->rent0;
-            }
+        case (TileType::Property):
+            this->refresh_street_rents(index, this->board_.propertyByTile(info.tile));
             break;
-        }
-        case (PropertyType::RAILROAD): {
+        case (TileType::Railroad):
             player.railroads_owned++;
-            const auto& rent_info = this->board_.railroads[0].rent;
-            int railroads_active = 0;
-            for (auto position : this->board_.railroad_positions) {
-                int index = this->position_to_properties_[position];
-                const PropertyView& railroad = this->properties_[index];
-                if (railroad.owner_index == player.player_index && !railroad.mortgaged) {
-                    railroads_active++;
-                }
-            }
-            assert(railroads_active >= 1);
-
-            for (auto position : this->board_.railroad_positions) {
-                int index = this->position_to_properties_[position];
-                PropertyView& railroad = this->properties_[index];
-                if (railroad.owner_index != player.player_index || railroad.mortgaged) {
-                    continue;
-                }
-                railroad.current_rent = rent_info[railroads_active - 1];
-            }
+            assert(this->state_.railroads_active[player.player_index] >= 1);
+            this->refresh_railroad_rents(player.player_index, false);
             break;
-        }
-        case (PropertyType::UTILITY): {
+        case (TileType::Utility):
             player.utilities_owned++;
-            int utilities_active = 0;
-            for (auto position : this->board_.utility_positions) {
-                int index = this->position_to_properties_[position];
-                const PropertyView& utility = this->properties_[index];
-                if (utility.owner_index == player.player_index && !utility.mortgaged) {
-                    utilities_active++;
-                }
-            }
-            assert(utilities_active >= 1);
-
-            const double average_roll = 7.0;
-            const auto& multipliers = this->board_.utilities[0].multiplier;
-            for (auto position : this->board_.utility_positions) {
-                int index = this->position_to_properties_[position];
-                PropertyView& utility = this->properties_[index];
-                if (utility.owner_index == player.player_index) {
-                    utility.current_rent = average_roll * multipliers[utilities_active - 1];
-                }
-            }
+            assert(this->state_.utilities_active[player.player_index] >= 1);
+            this->refresh_utility_rents(player.player_index);
             break;
-        }}
+        default:
+            break;
+        }
     }
 }
 
 // check legality in action handling, including handling even building
-void Engine::build_house(PlayerView& player, PropertyView* property) {
-    assert(!property->hotel);
-    assert(player.cash >= property->house_price);
+void Engine::build_house(PlayerView& player, uint32_t index) {
+    const OwnableInfo& info = this->board_.ownables[index];
+    const uint8_t houses = this->state_.houses[index];
+    assert(houses < GameState::HOTEL);
+    assert(player.cash >= info.house_cost);
 
-    const PropertyInfo* property_info = this->board_.propertyByTile(property->position);
-    if (property->houses < 4) {
+    const PropertyInfo* property_info = this->board_.propertyByTile(info.tile);
+    if (houses < 4) {
         assert(this->state_.houses_remaining > 0);
-        player.cash -= property->house_price;
+        player.cash -= info.house_cost;
         this->state_.houses_remaining--;
-        property->houses++;
-        property->current_rent = property_info->rent[property->houses];
     } else {
-        assert(property->houses == 4);
         assert(this->state_.hotels_remaining > 0);
-        player.cash -= property->house_price;
+        player.cash -= info.house_cost;
         this->state_.hotels_remaining--;
         this->state_.houses_remaining += 4;
-        property->houses++;
-        property->hotel = true;
-        property->current_rent = property_info->rent[property->houses];
     }
+    this->state_.set_houses(index, houses + 1);
+    this->state_.set_rent(index, property_info->rent[houses + 1]);
 }
 
-void Engine::sell_house(PlayerView& player, PropertyView* property) {
-    assert(property->owner_index == player.player_index);
-    assert(property->houses > 0);
+void Engine::sell_house(PlayerView& player, uint32_t index) {
+    const OwnableInfo& info = this->board_.ownables[index];
+    const uint8_t houses = this->state_.houses[index];
+    assert(this->state_.owner_of(index) == player.player_index);
+    assert(houses > 0);
 
-    const PropertyInfo* property_info = this->board_.propertyByTile(property->position);
-    if (!property->hotel) {
-        property->houses--;
-        property->current_rent = property_info->rent[property->houses];
+    const PropertyInfo* property_info = this->board_.propertyByTile(info.tile);
+    if (houses != GameState::HOTEL) {
+        this->state_.set_houses(index, houses - 1);
+        this->state_.set_rent(index, property_info->rent[houses - 1]);
         this->state_.houses_remaining++;
-        player.cash += property->house_price / 2;
+        player.cash += info.house_cost / 2;
         return;
     }
-    assert(property->houses == 5);
 
     if (this->state_.houses_remaining >= 4) {
-        property->hotel = false;
-        property->houses--;
-        property->current_rent = property_info->rent[property->houses];
+        this->state_.set_houses(index, houses - 1);
+        this->state_.set_rent(index, property_info->rent[houses - 1]);
         this->state_.hotels_remaining++;
         this->state_.houses_remaining -= 4;
-        player.cash += property->house_price / 2;
+        player.cash += info.house_cost / 2;
         return;
     }
 
     int houses_pool = this->state_.houses_remaining;
     const ColourGroup group = this->board_.tilesOfColour(property_info->colour);
     for (int i = 0; i < group.count; i++) {
-        int index = this->position_to_properties_[group.tiles[i]];
-        PropertyView* p = &this->properties_[index];
-        if (!p->hotel) {
-            houses_pool += p->houses;
+        int p = this->board_.ownableByTile(group.tiles[i]);
+        if (!this->state_.has_hotel(p)) {
+            houses_pool += this->state_.houses[p];
         }
     }
 
@@ -146,15 +97,13 @@ void Engine::sell_house(PlayerView& player, PropertyView* property) {
         if (houses_pool < (i + 1) * max_houses) {
             num_houses = max_houses - 1;
         }
-        int index = this->position_to_properties_[group.tiles[i]];
-        PropertyView* p = &this->properties_[index];
-        const PropertyInfo* p_info = this->board_.propertyByTile(p->position);
+        int p = this->board_.ownableByTile(group.tiles[i]);
+        const PropertyInfo* p_info = this->board_.propertyByTile(group.tiles[i]);
 
-        int cur_houses = p->houses;
-        p->houses = num_houses;
-        p->current_rent = p_info->rent[num_houses];
-        p->hotel = false;
-        if (cur_houses == 5) {
+        int cur_houses = this->state_.houses[p];
+        this->state_.set_houses(p, num_houses);
+        this->state_.set_rent(p, p_info->rent[num_houses]);
+        if (cur_houses == GameState::HOTEL) {
             this->state_.hotels_remaining++;
             houses_pool -= num_houses;
         } else {
@@ -165,4 +114,4 @@ void Engine::sell_house(PlayerView& player, PropertyView* property) {
     }
     this->state_.houses_remaining = houses_pool;
     return;
-}
\ No newline at end of file
+}
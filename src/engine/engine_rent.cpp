@@ -1,5 +1,6 @@
 #include "engine.h"
 #include "board.hpp"
+#include <bit>
 #include <cassert>
 
 uint32_t Engine::get_rent(PlayerView& player, bool max_rent) {
@@ -23,24 +24,24 @@ uint32_t Engine::get_rent(PlayerView& player, bool max_rent) {
 }
 
 uint32_t Engine::get_street_rent(PlayerView& player, const PropertyInfo* street) {
-    int index = this->position_to_properties_[player.position];
-    PropertyView& property = this->properties_[index];
-    assert(property.type == PropertyType::PROPERTY);
+    int index = this->board_.ownableByTile(player.position);
+    assert(this->board_.ownables[index].type == TileType::Property);
 
-    if (property.mortgaged || !property.is_owned || property.owner_index == player.player_index) {
+    if (this->state_.is_mortgaged(index) || !this->state_.is_owned(index) || this->state_.owner_of(index) == player.player_index) {
         return 0;
     }
 
     // Nothing built
-    if (!property.hotel && property.houses == 0) {
+    const uint8_t houses = this->state_.houses[index];
+    if (houses == 0) {
         uint32_t base_rent = street->rent[0];
         if (is_monopoly(street, true)) {
             return 2 * base_rent;
         }
         return base_rent;
-    } else if (!property.hotel) {
-        assert(property.houses <= 4);
-        return street->rent[property.houses]; // check indexing
+    } else if (houses != GameState::HOTEL) {
+        assert(houses <= 4);
+        return street->rent[houses]; // check indexing
     } else {
         // Must be a hotel
         return street->rent[-1];
@@ -48,27 +49,25 @@ uint32_t Engine::get_street_rent(PlayerView& player, const PropertyInfo* street)
 }
 
 uint32_t Engine::get_railroad_rent(PlayerView& player, const int railroadIndex) {
-    int index = this->position_to_properties_[player.position];
-    PropertyView& railroad = this->properties_[index];
-    assert(railroad.type == PropertyType::RAILROAD);
+    int index = this->board_.ownableByTile(player.position);
+    assert(this->board_.ownables[index].type == TileType::Railroad);
 
-    if (!railroad.is_owned || railroad.mortgaged || railroad.owner_index == player.player_index) {
+    if (!this->state_.is_owned(index) || this->state_.is_mortgaged(index) || this->state_.owner_of(index) == player.player_index) {
         return 0;
     }
-    return railroad.current_rent;
+    return this->state_.rent[index];
 }
 
 uint32_t Engine::get_utility_rent(PlayerView& player, const int utilityIndex, bool max_rent) {
-    int index = this->position_to_properties_[player.position];
-    PropertyView& utility = this->properties_[index];
-    assert(utility.type == PropertyType::UTILITY);
+    int index = this->board_.ownableByTile(player.position);
+    assert(this->board_.ownables[index].type == TileType::Utility);
 
-    if (!utility.is_owned || utility.mortgaged || utility.owner_index == player.player_index) {
+    if (!this->state_.is_owned(index) || this->state_.is_mortgaged(index) || this->state_.owner_of(index) == player.player_index) {
         return 0;
     }
 
     RollResult roll = this->dice_roll();
-    PlayerView& utility_owner = players_[utility.owner_index];
+    PlayerView& utility_owner = this->state_.players[this->state_.owner_of(index)];
     assert(utility_owner.utilities_owned <= 2);
     if (utility_owner.utilities_owned == 1 && !max_rent) {
         return 4 * (roll.roll_1 + roll.roll_2);
@@ -77,117 +76,81 @@ uint32_t Engine::get_utility_rent(PlayerView& player, const int utilityIndex, bo
     }
 }
 
-void Engine::update_rent(PropertyView& property) {
-    const PropertyInfo* property_info = this->board_.propertyByTile(property.position);
+void Engine::update_rent(uint32_t index) {
+    const OwnableInfo& info = this->board_.ownables[index];
+    const PropertyInfo* property_info = this->board_.propertyByTile(info.tile);
 
-    if (!property.is_owned || !property.mortgaged) {
-        property.current_rent = 0;
+    if (!this->state_.is_owned(index) || !this->state_.is_mortgaged(index)) {
+        this->state_.set_rent(index, 0);
         return;
     }
     
-    switch (property.type)
+    switch (info.type)
     {
-    case (PropertyType::PROPERTY): {
-        if (property.houses > 0) {
-            property.current_rent = property_info->rent[property.houses];
+    case (TileType::Property): {
+        if (this->state_.houses[index] > 0) {
+            this->state_.set_rent(index, property_info->rent[this->state_.houses[index]]);
         }
 
-        if (is_monopoly(property_info, true)) {
-            ColourGroup group = this->board_.tilesOfColour(property_info->colour);
-            for (int i = 0; i < group.count; i++) {
-                int index = this->position_to_properties_[group.tiles[i]];
-                PropertyView& p = this->properties_[index];
-                p.is_monopoly = true;
-                if (p.houses == 0) {
-                    p.current_rent = p.rent0 * 2;
-                }
-            }
-        } else {
-            property.current_rent = property.rent0;
-        }
+        this->refresh_street_rents(index, property_info);
         break;
     }
-    case (PropertyType::RAILROAD): {
-        PlayerView& player = this->players_[property.owner_index];
-        const auto& rent_info = this->board_.railroads[0].rent;
-        int railroads_active = 0;
-        for (auto position : this->board_.railroad_positions) {
-            int index = this->position_to_properties_[position];
-            const PropertyView& railroad = this->properties_[index];
-            if (railroad.owner_index == player.player_index && !railroad.mortgaged) {
-                railroads_active++;
-            }
-        }
-
-        for (auto position : this->board_.railroad_positions) {
-            int index = this->position_to_properties_[position];
-            PropertyView& railroad = this->properties_[index];
-            if (railroad.owner_index != player.player_index || railroad.mortgaged) {
-                continue;
-            }
-            railroad.current_rent = rent_info[railroads_active - 1];
-        }
+    case (TileType::Railroad):
+        this->refresh_railroad_rents(this->state_.owner_of(index), false);
+        break;
+    case (TileType::Utility):
+        this->refresh_utility_rents(this->state_.owner_of(index));
+        break;
+    default:
         break;
     }
-    case (PropertyType::UTILITY): {
-        PlayerView& player = this->players_[property.owner_index];
-        int utilities_active = 0;
-        for (auto position : this->board_.utility_positions) {
-            int index = this->position_to_properties_[position];
-            const PropertyView& utility = this->properties_[index];
-            if (utility.owner_index == player.player_index && !utility.mortgaged) {
-                utilities_active++;
-            }
-        }
+}
 
-        const double average_roll = 7.0;
-        const auto& multipliers = this->board_.utilities[0].multiplier;
-        for (auto position : this->board_.utility_positions) {
-            int index = this->position_to_properties_[position];
-            PropertyView& utility = this->properties_[index];
-            if (utility.owner_index == player.player_index) {
-                utility.current_rent = average_roll * multipliers[utilities_active - 1];
+// Only the changed property's colour group is touched
+void Engine::refresh_street_rents(uint32_t index, const PropertyInfo* street) {
+    if (is_monopoly(street, true)) {
+        for (uint32_t bits = this->board_.colourMask(street->colour); bits; bits &= bits - 1) {
+            const uint32_t p = std::countr_zero(bits);
+            this->state_.mark_monopoly(p);
+            if (this->state_.houses[p] == 0) {
+                this->state_.set_rent(p, this->board_.propertyByTile(this->board_.ownables[p].tile)->rent[0] * 2);
             }
         }
-        break;
-    }}
+    } else {
+        this->state_.set_rent(index, street->rent[0]);
+    }
 }
 
-// active_monopoly to see if all unmortgaged as well
-bool Engine::is_monopoly(const PropertyInfo* street, bool active_monopoly) {
-    const ColourGroup& colour_group = this->board_.tilesOfColour(street->colour);
-    uint32_t owner = -1;
-    for (int i = 0; i < colour_group.count; i++) {
-        PropertyView& property = this->properties_[this->position_to_properties_[colour_group.tiles[i]]];
-        // no monopoly if unowned property
-        if (!property.is_owned) {
-            return false;
-        }
+void Engine::refresh_railroad_rents(uint32_t owner_index, bool include_mortgaged) {
+    const auto& rent_info = this->board_.railroads[0].rent;
+    const int railroads_active = this->state_.railroads_active[owner_index];
+    uint32_t railroads = this->state_.owned_by(owner_index) & this->board_.railroad_mask;
+    if (!include_mortgaged) {
+        railroads &= ~this->state_.mortgaged_mask;
+    }
+    for (uint32_t bits = railroads; bits; bits &= bits - 1) {
+        this->state_.set_rent(std::countr_zero(bits), rent_info[railroads_active - 1]);
+    }
+}
 
-        if (active_monopoly && property.mortgaged) {
-            return false;
-        }
-        // init
-        if (owner == -1) {
-            owner = property.owner_index;
-        } else if (owner != property.owner_index) {
-            return false;
-        }
+// Mortgaged utilities included, as before
+void Engine::refresh_utility_rents(uint32_t owner_index) {
+    const double average_roll = 7.0;
+    const auto& multipliers = this->board_.utilities[0].multiplier;
+    const int utilities_active = this->state_.utilities_active[owner_index];
+    for (uint32_t bits = this->state_.owned_by(owner_index) & this->board_.utility_mask; bits; bits &= bits - 1) {
+        this->state_.set_rent(std::countr_zero(bits), static_cast<int32_t>(average_roll * multipliers[utilities_active - 1]));
     }
-    return true;
 }
 
-bool Engine::developed_monopoly(PropertyView* property) {
-    if (property->houses > 0) {
+// active_monopoly to see if all unmortgaged as well
+bool Engine::is_monopoly(const PropertyInfo* street, bool active_monopoly) {
+    return this->state_.is_monopoly(street->colour, active_monopoly);
+}
+
+bool Engine::developed_monopoly(uint32_t index) {
+    if (this->state_.houses[index] > 0) {
         return true;
     }
-    const ColourGroup& group = this->board_.tilesOfColour(static_cast<Colour>(property->colour_id));
-    for (int i = 0; i < group.count; i++) {
-        int index = this->position_to_properties_[group.tiles[i]];
-        PropertyView* p = &this->properties_[index];
-        if (p->houses > 0) {
-            return true;
-        }
-    }
-    return false;
-}
\ No newline at end of file
+    return (this->state_.developed_mask & this->board_.colourMask(this->board_.ownables[index].colour)) != 0;
+}
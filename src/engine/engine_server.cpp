@@ -0,0 +1,191 @@
+#include "engine_server.h"
+#include "agent_pool.h"
+#include "game_runner.h"
+#include "json_reader.h"
+#include "manifest.h"
+#include "result_json.h"
+#include "log.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+
+int serve(const std::string& socket_path, unsigned int threads) {
+    LOG(ERROR, "--serve is not supported on Windows");
+    return EXIT_FAILURE;
+}
+
+#else
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+// Guards against a garbage length prefix allocating the world
+constexpr uint32_t MAX_FRAME_BYTES = 64u << 20;
+
+bool read_exact(int fd, char* out, size_t size) {
+    while (size > 0) {
+        ssize_t got = ::read(fd, out, size);
+        if (got <= 0) {
+            return false;
+        }
+        out += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool write_exact(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::write(fd, data, size);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool read_frame(int fd, std::string& payload) {
+    unsigned char header[4];
+    if (!read_exact(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+    }
+    uint32_t size = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    if (size > MAX_FRAME_BYTES) {
+        return false;
+    }
+    payload.resize(size);
+    return read_exact(fd, payload.data(), size);
+}
+
+bool write_frame(int fd, const std::string& payload) {
+    uint32_t size = static_cast<uint32_t>(payload.size());
+    unsigned char header[4] = {
+        static_cast<unsigned char>(size),
+        static_cast<unsigned char>(size >> 8),
+        static_cast<unsigned char>(size >> 16),
+        static_cast<unsigned char>(size >> 24),
+    };
+    return write_exact(fd, reinterpret_cast<const char*>(header), sizeof(header))
+        && write_exact(fd, payload.data(), payload.size());
+}
+
+// Turns one request payload into NDJSON results, errors are reported per game like batch mode
+std::string handle_request(const std::string& payload, ManifestParser& parser, GameRunner& runner) {
+    std::string reply;
+    JsonValue request;
+    try {
+        request = parse_json(payload);
+    } catch (const std::exception& e) {
+        return error_json(0, e.what()) + '\n';
+    }
+
+    std::vector<const JsonValue*> entries;
+    if (request.is_array()) {
+        for (const auto& item : request.items) {
+            entries.push_back(&item);
+        }
+    } else {
+        entries.push_back(&request);
+    }
+
+    std::vector<GameConfig> configs;
+    std::vector<std::string> parse_errors(entries.size());
+    std::vector<int> config_index(entries.size(), -1);
+    for (size_t i = 0; i < entries.size(); i++) {
+        try {
+            configs.push_back(parser.parse(*entries[i]));
+            config_index[i] = static_cast<int>(configs.size() - 1);
+        } catch (const std::exception& e) {
+            parse_errors[i] = e.what();
+        }
+    }
+
+    std::vector<GameRunner::Outcome> outcomes = runner.run(configs);
+    JsonWriter out(reply);
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (config_index[i] < 0) {
+            write_error_json(out, 0, parse_errors[i]);
+        } else {
+            GameRunner::Outcome& outcome = outcomes[config_index[i]];
+            if (outcome.error.empty()) {
+                write_json(out, outcome.result);
+            } else {
+                write_error_json(out, configs[config_index[i]].game_id, outcome.error);
+            }
+        }
+        out.raw('\n');
+    }
+    return reply;
+}
+
+void serve_connection(int fd, GameRunner& runner) {
+    // Config files are re-read per connection, agents are still shared through the pool
+    ManifestParser parser;
+    std::string payload;
+    while (read_frame(fd, payload)) {
+        if (!write_frame(fd, handle_request(payload, parser, runner))) {
+            break;
+        }
+    }
+    ::close(fd);
+}
+}
+
+int serve(const std::string& socket_path, unsigned int threads) {
+    // A client hanging up mid-reply must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        LOG(ERROR, "Socket path too long: ", socket_path);
+        return EXIT_FAILURE;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        LOG(ERROR, "socket() failed: ", std::strerror(errno));
+        return EXIT_FAILURE;
+    }
+    // Stale socket file from a previous server
+    ::unlink(socket_path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || ::listen(listener, SOMAXCONN) < 0) {
+        LOG(ERROR, "Failed to listen on ", socket_path, ": ", std::strerror(errno));
+        ::close(listener);
+        return EXIT_FAILURE;
+    }
+
+    AgentPool pool;
+    GameRunner runner(threads, &pool);
+    LOG(INFO, "Serving on ", socket_path, " with ", runner.threads(), " worker threads");
+
+    while (true) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            // Out of descriptors and the like are transient, connection threads still hold the runner
+            if (errno != EINTR) {
+                LOG(ERROR, "accept() failed: ", std::strerror(errno));
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            continue;
+        }
+        // Connections only parse and wait, the games themselves run on the runner's workers
+        std::thread(serve_connection, client, std::ref(runner)).detach();
+    }
+}
+
+#endif
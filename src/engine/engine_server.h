@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+// Long-lived engine listening on a Unix domain socket.
+// Each request is a frame: 4-byte little-endian payload length, then a UTF-8 JSON payload holding
+// one manifest entry or an array of them. The reply is one frame of NDJSON results in request order.
+// Agent libraries stay loaded and agent instances stay warm across requests and connections.
+// Returns only on setup failure.
+int serve(const std::string& socket_path, unsigned int threads);
@@ -11,17 +11,16 @@ void Engine::trade(PlayerView& playerA, TradeDetail& playerA_assets, PlayerView&
 
     for (uint8_t i = 0; i < playerA_assets.property_num; i++) {
         uint32_t position = playerA_assets.properties[i];
-        int index = this->position_to_properties_[position];
-        PropertyView& asset = this->properties_[index];
-        asset.owner_index = playerB.player_index;
-        if (asset.type == PropertyType::RAILROAD) {
+        int index = this->board_.ownableByTile(position);
+        this->state_.set_owner(index, playerB.player_index);
+        if (this->board_.ownables[index].type == TileType::Railroad) {
             playerB.railroads_owned++;
             playerA.railroads_owned--;
-        } else if (asset.type == PropertyType::UTILITY) {
+        } else if (this->board_.ownables[index].type == TileType::Utility) {
             playerB.utilities_owned++;
             playerA.utilities_owned--;
         }
-        this->update_rent(asset);
+        this->update_rent(index);
     }
 
     // playerB_assets -> player A
@@ -34,17 +33,16 @@ void Engine::trade(PlayerView& playerA, TradeDetail& playerA_assets, PlayerView&
 
     for (uint8_t i = 0; i < playerB_assets.property_num; i++) {
         uint32_t position = playerB_assets.properties[i];
-        int index = this->position_to_properties_[position];
-        PropertyView& asset = this->properties_[index];
-        asset.owner_index = playerA.player_index;
-        if (asset.type == PropertyType::RAILROAD) {
+        int index = this->board_.ownableByTile(position);
+        this->state_.set_owner(index, playerA.player_index);
+        if (this->board_.ownables[index].type == TileType::Railroad) {
             playerA.railroads_owned++;
             playerB.railroads_owned--;
-        } else if (asset.type == PropertyType::UTILITY) {
+        } else if (this->board_.ownables[index].type == TileType::Utility) {
             playerA.utilities_owned++;
             playerB.utilities_owned--;
         }
-        this->update_rent(asset);
+        this->update_rent(index);
     }
 }
 
@@ -63,12 +61,11 @@ bool Engine::legal_trade_detail(PlayerView& player, TradeDetail& assets) {
 
     for (int i = 0; i < assets.property_num; i++) {
         uint32_t asset_position = assets.properties[i];
-        int index = this->position_to_properties_[asset_position];
+        int index = this->board_.ownableByTile(asset_position);
         if (index == -1) {
             return false;
         }
-        PropertyView* property = &this->properties_[index];
-        if (property->owner_index != player.player_index) {
+        if (this->state_.owner_of(index) != player.player_index) {
             return false;
         }
     }
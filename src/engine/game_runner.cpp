@@ -0,0 +1,103 @@
+#include "game_runner.h"
+#include "plugin_loader.h"
+#include <algorithm>
+#include <exception>
+
+bool agents_thread_safe(const GameConfig& config) {
+    for (const auto& spec : config.agent_specs) {
+        AgentExport exported = LoadAgentLibrary(spec.path)->make(spec.config_json);
+        if (!(exported.vtable.flags & (AGENT_FLAG_THREAD_SAFE | AGENT_FLAG_THREAD_CONFINED))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+GameRunner::GameRunner(unsigned int threads, AgentPool* pool) : pool_(pool) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (unsigned int i = 0; i < threads; i++) {
+        workers_.emplace_back(&GameRunner::worker_loop, this);
+    }
+}
+
+GameRunner::~GameRunner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::vector<GameRunner::Outcome> GameRunner::run(const std::vector<GameConfig>& configs) {
+    std::vector<Outcome> outcomes(configs.size());
+    this->run(configs, [&outcomes](size_t index, Outcome& outcome) {
+        outcomes[index] = std::move(outcome);
+    });
+    return outcomes;
+}
+
+void GameRunner::run(const std::vector<GameConfig>& configs, const OutcomeCallback& on_outcome) {
+    std::vector<Slot> slots(configs.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < configs.size(); i++) {
+            jobs_.push({&configs[i], &slots[i], next_sequence_++});
+        }
+    }
+    work_ready_.notify_all();
+
+    for (size_t i = 0; i < configs.size(); i++) {
+        Outcome outcome;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            slot_done_.wait(lock, [&slots, i] { return slots[i].done; });
+            outcome = std::move(slots[i].outcome);
+        }
+        on_outcome(i, outcome);
+    }
+}
+
+void GameRunner::worker_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = jobs_.top();
+            jobs_.pop();
+        }
+
+        Outcome outcome = this->play(*job.config);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job.slot->outcome = std::move(outcome);
+            job.slot->done = true;
+        }
+        slot_done_.notify_all();
+    }
+}
+
+GameRunner::Outcome GameRunner::play(const GameConfig& config) {
+    Outcome outcome;
+    try {
+        // Engine and its agents live entirely on this thread, which is all AGENT_FLAG_THREAD_CONFINED asks for
+        std::unique_lock<std::recursive_mutex> serial(SerialPluginMutex(), std::defer_lock);
+        if (!agents_thread_safe(config)) {
+            serial.lock();
+        }
+        Engine engine(config, pool_);
+        outcome.result = engine.run();
+    } catch (const std::exception& e) {
+        outcome.error = e.what();
+    }
+    return outcome;
+}
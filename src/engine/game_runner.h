@@ -0,0 +1,74 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "engine.h"
+
+class AgentPool;
+
+// Runs independent games on a fixed pool of worker threads, one Engine per game.
+// Pending games are handed out longest max_turns first so a 1500-turn game never starts last,
+// and each run() reports its outcomes in submission order. Several threads may call run() at
+// once (e.g. one per server connection), their games share the same workers.
+class GameRunner {
+public:
+    struct Outcome {
+        GameResult result;
+        std::string error; // non-empty if the game threw, result is then empty
+    };
+    using OutcomeCallback = std::function<void(size_t index, Outcome& outcome)>;
+
+    // 0 threads = one per hardware thread. With a pool, agents stay warm between games.
+    explicit GameRunner(unsigned int threads = 0, AgentPool* pool = nullptr);
+    ~GameRunner();
+
+    GameRunner(const GameRunner&) = delete;
+    GameRunner& operator=(const GameRunner&) = delete;
+
+    std::vector<Outcome> run(const std::vector<GameConfig>& configs);
+    // Calls on_outcome on the calling thread as soon as every earlier game has been reported
+    void run(const std::vector<GameConfig>& configs, const OutcomeCallback& on_outcome);
+
+    unsigned int threads() const { return static_cast<unsigned int>(workers_.size()); };
+
+private:
+    struct Slot {
+        Outcome outcome;
+        bool done = false;
+    };
+
+    struct Job {
+        const GameConfig* config;
+        Slot* slot;
+        uint64_t sequence; // submission order, breaks max_turns ties
+
+        // priority_queue pops the largest, i.e. longest game, earliest submitted
+        bool operator<(const Job& other) const {
+            if (config->max_turns != other.config->max_turns) {
+                return config->max_turns < other.config->max_turns;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    void worker_loop();
+    Outcome play(const GameConfig& config);
+
+    AgentPool* pool_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable slot_done_;
+    std::priority_queue<Job> jobs_;
+    uint64_t next_sequence_ = 0;
+    bool stopping_ = false;
+};
+
+// True if every agent library in the config declares AGENT_FLAG_THREAD_SAFE or AGENT_FLAG_THREAD_CONFINED
+bool agents_thread_safe(const GameConfig& config);
@@ -0,0 +1,109 @@
+#include "game_state.h"
+#include "board.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+GameState GameState::initial(uint64_t seed, uint32_t num_players, uint32_t max_turns, bool reshuffle_decks,
+                             RngBackend rng_backend) {
+    // Maybe should be in config.json, but not needed rn
+    static constexpr uint32_t STARTING_CASH = 1500;
+
+    if (num_players > MAX_PLAYERS) {
+        throw std::runtime_error("too many players, at most " + std::to_string(MAX_PLAYERS));
+    }
+
+    GameState state{};
+    state.rng.seed(rng_backend, rng_backend == RngBackend::XOSHIRO256 ? derive_seed(seed, 0) : seed);
+
+    state.game_id = seed;
+    state.num_players = num_players;
+    state.houses_remaining = 32;
+    state.hotels_remaining = 12;
+    state.max_turns = max_turns;
+
+    // To get player info with player_index i, its players[i]
+    for (uint32_t i = 0; i < num_players; i++) {
+        auto& player = state.players[i];
+        player.player_index = i;
+        player.cash = STARTING_CASH;
+        player.position = 0;
+        player.retired = false;
+
+        player.previous_offer = {};
+        player.trades_offered = 0;
+        player.offer_accepted = false;
+
+        player.in_jail = false;
+        player.turns_in_jail = 0;
+        player.jail_free_cards = 0;
+        player.double_rolls = 0;
+        player.jail_rolled_this_turn = false;
+
+        player.railroads_owned = 0;
+        player.utilities_owned = 0;
+    }
+
+    const Board& b = board();
+    for (uint32_t i = 0; i < NUM_TILES; i++) {
+        const int index = b.ownableByTile(i);
+        if (index == -1) {
+            continue;
+        }
+        auto& property = state.properties[index];
+        property.position = i;
+        property.owner_index = -1;
+        property.is_owned = false;
+        property.mortgaged = false;
+        property.auctioned_this_turn = false;
+        property.current_rent = 0;
+
+        switch (b.tiles[i].type) {
+        case TileType::Property: {
+            const PropertyInfo* street = b.propertyByTile(i);
+            property.property_id = street->property_id;
+            property.type = PropertyType::PROPERTY;
+            property.colour_id = static_cast<uint8_t>(street->colour);
+            property.house_price = street->house_cost;
+            property.houses = 0;
+            property.hotel = false;
+            property.is_monopoly = false;
+            property.purchase_price = street->purchase_price;
+            auto& rent_values = street->rent;
+            std::tie(property.rent0, property.rent1, property.rent2, property.rent3, property.rent4, property.rentH) =
+                std::make_tuple(rent_values[0], rent_values[1], rent_values[2], rent_values[3], rent_values[4], rent_values[5]);
+            break;
+        }
+        case TileType::Railroad: {
+            const RailroadInfo& railroad = b.railroads[b.railroadByTile(i)];
+            property.property_id = railroad.railroad_id;
+            property.type = PropertyType::RAILROAD;
+            property.purchase_price = railroad.purchase_price;
+            break;
+        }
+        case TileType::Utility: {
+            const UtilityInfo& utility = b.utilities[b.utilityByTile(i)];
+            property.property_id = utility.utility_id;
+            property.type = PropertyType::UTILITY;
+            property.purchase_price = utility.purchase_price;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    state.rebuild_masks();
+
+    for (CardDeck* deck : {&state.community_deck, &state.chance_deck}) {
+        std::iota(deck->cards.begin(), deck->cards.end(), 0);
+        deck->head = 0;
+        deck->count = CardDeck::CAPACITY;
+        deck->reshuffle = reshuffle_decks;
+        deck->jail_card_out = false;
+        deck->shuffle(state.rng);
+    }
+
+    return state;
+}
@@ -0,0 +1,344 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include "state_view.h"
+#include "rng.h"
+#include "board.hpp"
+
+// Fixed-capacity ring buffer, drawn from the front and refilled at the back.
+// In reshuffle mode returned cards are not drawn again until the undrawn ones run out,
+// then the whole deck is shuffled.
+struct CardDeck {
+    static constexpr uint32_t CAPACITY = 16;
+
+    std::array<uint32_t, CAPACITY> cards;
+    uint32_t head;
+    uint32_t count;
+    uint32_t undrawn; // cards left before the next reshuffle
+    bool reshuffle;
+    // Get out of jail free card drawn and not returned. Bankruptcy drops held cards, so it can stay out.
+    bool jail_card_out;
+
+    uint32_t size() const {
+        return count;
+    };
+
+    template <class Rng>
+    uint32_t draw(Rng& rng) {
+        if (reshuffle && undrawn == 0) {
+            shuffle(rng);
+        }
+        assert(count > 0);
+        uint32_t card = cards[head];
+        head = (head + 1) % CAPACITY;
+        count--;
+        if (undrawn > 0) {
+            undrawn--;
+        }
+        return card;
+    };
+
+    void push_back(uint32_t card) {
+        assert(count < CAPACITY);
+        cards[(head + count) % CAPACITY] = card;
+        count++;
+    };
+
+    // Every card in the deck becomes undrawn again, in a new order
+    template <class Rng>
+    void shuffle(Rng& rng) {
+        std::array<uint32_t, CAPACITY> ordered;
+        for (uint32_t i = 0; i < count; i++) {
+            ordered[i] = cards[(head + i) % CAPACITY];
+        }
+        shuffle_range(ordered.begin(), ordered.begin() + count, rng);
+        cards = ordered;
+        head = 0;
+        undrawn = count;
+    };
+};
+
+enum class AuctionMode : uint8_t {
+    ROUNDS, // players are asked round after round until nobody raises
+    PROXY,  // each player gives its top bid once, the price rises by the increment as in an English auction
+};
+
+// Parses "rounds" / "proxy"; false for anything else
+inline bool parse_auction_mode(std::string_view name, AuctionMode& mode) {
+    if (name == "rounds") {
+        mode = AuctionMode::ROUNDS;
+    } else if (name == "proxy") {
+        mode = AuctionMode::PROXY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* auction_mode_name(AuctionMode mode) {
+    return mode == AuctionMode::PROXY ? "proxy" : "rounds";
+}
+
+// Everything a game position is made of, in one flat value: copying it clones the game,
+// rng included. Agents and the board are not part of it.
+struct GameState {
+    static constexpr uint32_t MAX_PLAYERS = 8;
+    static constexpr uint32_t NUM_PROPERTIES = 28;
+    static constexpr uint32_t NUM_TILES = 40;
+    static constexpr uint32_t NUM_COLOURS = 9;
+    static constexpr uint32_t NO_OWNER = static_cast<uint32_t>(-1);
+    static constexpr uint8_t NO_OWNER_BYTE = 0xff;
+    static constexpr uint8_t HOTEL = 5; // houses[] value of a hotel
+    static constexpr uint32_t COMMUNITY_JAIL_CARD = 4;
+    static constexpr uint32_t CHANCE_JAIL_CARD = 8;
+
+    uint32_t game_id;
+    uint32_t houses_remaining;
+    uint32_t hotels_remaining;
+    uint32_t current_player_index; // last player asked for a decision
+    uint32_t num_players;
+    uint32_t owed;
+
+    uint32_t turn;
+    uint32_t max_turns;
+    uint32_t active_player; // player whose turn is being played, or is next
+    AuctionMode auction_mode;
+    uint32_t auction_increment; // PROXY: the winner pays the second bid plus this, at most their own
+
+    std::array<PlayerView, MAX_PLAYERS> players;
+    // Ownable tiles in board order, as agents see them. The rules work on the arrays below;
+    // sync_properties() copies them back in before anyone reads these.
+    std::array<PropertyView, NUM_PROPERTIES> properties;
+    std::array<double, MAX_PLAYERS> penalties;
+
+    // Working property state, indexed like properties[]. Change it through the setters below
+    // so the bitboards and counts stay in sync. owner, houses and the two masks share a cache line.
+    alignas(64) std::array<uint8_t, NUM_PROPERTIES> owner; // NO_OWNER_BYTE for none
+    std::array<uint8_t, NUM_PROPERTIES> houses; // HOTEL for a hotel
+    uint32_t mortgaged_mask;
+    uint32_t developed_mask; // houses or hotel
+
+    std::array<uint32_t, MAX_PLAYERS> owned_mask;
+    std::array<int32_t, NUM_PROPERTIES> rent; // current rent
+    uint32_t auctioned_mask; // auctioned this turn
+    uint32_t monopoly_mask; // streets whose group was a monopoly at some point, is_monopoly for agents
+    uint32_t stale_mask; // properties[] entries behind the working state
+
+    // Maintained by the same setters
+    std::array<uint8_t, MAX_PLAYERS> railroads_active; // owned and unmortgaged
+    std::array<uint8_t, MAX_PLAYERS> utilities_active;
+    std::array<uint32_t, NUM_COLOURS> colour_owner; // player owning the whole colour group, else NO_OWNER
+
+    CardDeck community_deck;
+    CardDeck chance_deck;
+
+    GameRng rng;
+
+    // Fresh game: starting cash, unowned properties, decks shuffled with rng seeded from seed.
+    // XOSHIRO256 seeds from derive_seed(seed, 0); agents of that game get streams 1..n.
+    static GameState initial(uint64_t seed, uint32_t num_players, uint32_t max_turns, bool reshuffle_decks = false,
+                             RngBackend rng_backend = RngBackend::MT19937);
+
+    uint32_t owned_by(uint32_t player_index) const {
+        return player_index < MAX_PLAYERS ? owned_mask[player_index] : 0;
+    };
+    uint32_t mortgaged_by(uint32_t player_index) const {
+        return owned_by(player_index) & mortgaged_mask;
+    };
+    uint32_t developed_by(uint32_t player_index) const {
+        return owned_by(player_index) & developed_mask;
+    };
+
+    // NO_OWNER for none
+    uint32_t owner_of(uint32_t index) const {
+        return owner[index] < MAX_PLAYERS ? owner[index] : NO_OWNER;
+    };
+    bool is_owned(uint32_t index) const {
+        return owner[index] < MAX_PLAYERS;
+    };
+    bool is_mortgaged(uint32_t index) const {
+        return (mortgaged_mask >> index) & 1;
+    };
+    bool has_hotel(uint32_t index) const {
+        return houses[index] == HOTEL;
+    };
+    bool was_auctioned(uint32_t index) const {
+        return (auctioned_mask >> index) & 1;
+    };
+
+    // Whole group owned by one player, and with active also none of it mortgaged
+    bool is_monopoly(Colour colour, bool active) const {
+        if (colour_owner[static_cast<size_t>(colour)] == NO_OWNER) {
+            return false;
+        }
+        return !active || (mortgaged_mask & board().colourMask(colour)) == 0;
+    };
+
+    // owner_index NO_OWNER for none
+    void set_owner(uint32_t index, uint32_t owner_index) {
+        const uint32_t bit = 1u << index;
+        const bool active = !is_mortgaged(index);
+        if (is_owned(index)) {
+            owned_mask[owner[index]] &= ~bit;
+            if (active) {
+                count_active(index, owner[index], -1);
+            }
+        }
+        if (owner_index < MAX_PLAYERS) {
+            owned_mask[owner_index] |= bit;
+            if (active) {
+                count_active(index, owner_index, 1);
+            }
+        }
+        owner[index] = owner_index < MAX_PLAYERS ? static_cast<uint8_t>(owner_index) : NO_OWNER_BYTE;
+        const Colour colour = board().ownables[index].colour;
+        if (colour != Colour::None) {
+            update_colour_owner(colour);
+        }
+        stale_mask |= bit;
+    };
+
+    void set_mortgaged(uint32_t index, bool mortgaged) {
+        const uint32_t bit = 1u << index;
+        if (is_mortgaged(index) != mortgaged && is_owned(index)) {
+            count_active(index, owner[index], mortgaged ? -1 : 1);
+        }
+        mortgaged_mask = mortgaged ? (mortgaged_mask | bit) : (mortgaged_mask & ~bit);
+        stale_mask |= bit;
+    };
+
+    // HOTEL for a hotel
+    void set_houses(uint32_t index, uint8_t count) {
+        const uint32_t bit = 1u << index;
+        developed_mask = count > 0 ? (developed_mask | bit) : (developed_mask & ~bit);
+        houses[index] = count;
+        stale_mask |= bit;
+    };
+
+    void set_rent(uint32_t index, int32_t value) {
+        rent[index] = value;
+        stale_mask |= 1u << index;
+    };
+
+    void set_auctioned(uint32_t index, bool auctioned) {
+        const uint32_t bit = 1u << index;
+        auctioned_mask = auctioned ? (auctioned_mask | bit) : (auctioned_mask & ~bit);
+        stale_mask |= bit;
+    };
+
+    void mark_monopoly(uint32_t index) {
+        monopoly_mask |= 1u << index;
+        stale_mask |= 1u << index;
+    };
+
+    // Takes the working state from properties, for states assembled by hand
+    void rebuild_masks() {
+        owned_mask = {};
+        mortgaged_mask = 0;
+        developed_mask = 0;
+        auctioned_mask = 0;
+        monopoly_mask = 0;
+        railroads_active = {};
+        utilities_active = {};
+        for (uint32_t index = 0; index < NUM_PROPERTIES; index++) {
+            const PropertyView& property = properties[index];
+            const uint32_t bit = 1u << index;
+            owner[index] = property.owner_index < MAX_PLAYERS ? static_cast<uint8_t>(property.owner_index) : NO_OWNER_BYTE;
+            houses[index] = property.hotel ? HOTEL : property.houses;
+            rent[index] = property.current_rent;
+            if (property.owner_index < MAX_PLAYERS) {
+                owned_mask[property.owner_index] |= bit;
+                if (!property.mortgaged) {
+                    count_active(index, property.owner_index, 1);
+                }
+            }
+            if (property.mortgaged) {
+                mortgaged_mask |= bit;
+            }
+            if (houses[index] > 0) {
+                developed_mask |= bit;
+            }
+            if (property.auctioned_this_turn) {
+                auctioned_mask |= bit;
+            }
+            if (property.is_monopoly) {
+                monopoly_mask |= bit;
+            }
+        }
+        for (uint32_t colour = 0; colour < NUM_COLOURS; colour++) {
+            update_colour_owner(static_cast<Colour>(colour));
+        }
+        stale_mask = ~0u;
+        sync_properties();
+    };
+
+    // Copies the entries that changed since the last call into properties[]
+    void sync_properties() {
+        for (uint32_t bits = stale_mask & ((1u << NUM_PROPERTIES) - 1); bits; bits &= bits - 1) {
+            const uint32_t index = std::countr_zero(bits);
+            PropertyView& property = properties[index];
+            property.owner_index = owner_of(index);
+            property.is_owned = is_owned(index);
+            property.mortgaged = is_mortgaged(index);
+            property.houses = houses[index];
+            property.hotel = has_hotel(index);
+            property.current_rent = rent[index];
+            property.auctioned_this_turn = was_auctioned(index);
+            property.is_monopoly = (monopoly_mask >> index) & 1;
+        }
+        stale_mask = 0;
+    };
+
+    std::span<PlayerView> seated_players() {
+        return {players.data(), num_players};
+    };
+    std::span<const PlayerView> seated_players() const {
+        return {players.data(), num_players};
+    };
+
+    // railroads_active / utilities_active only count unmortgaged properties
+    void count_active(uint32_t index, uint32_t player_index, int delta) {
+        const TileType type = board().ownables[index].type;
+        if (type == TileType::Railroad) {
+            railroads_active[player_index] += delta;
+        } else if (type == TileType::Utility) {
+            utilities_active[player_index] += delta;
+        }
+    };
+
+    void update_colour_owner(Colour colour) {
+        const uint32_t mask = board().colourMask(colour);
+        if (mask == 0) {
+            colour_owner[static_cast<size_t>(colour)] = NO_OWNER;
+            return;
+        }
+        const uint32_t first_owner = owner_of(std::countr_zero(mask));
+        const bool whole_group = first_owner < MAX_PLAYERS && (owned_mask[first_owner] & mask) == mask;
+        colour_owner[static_cast<size_t>(colour)] = whole_group ? first_owner : NO_OWNER;
+    };
+
+    // View for agents, points into this state. properties[] must be in sync.
+    GameStateView view() const {
+        GameStateView view = {};
+        view.game_id = game_id;
+        view.houses_remaining = houses_remaining;
+        view.hotels_remaining = hotels_remaining;
+        view.current_player_index = current_player_index;
+        view.players = players.data();
+        view.players_remaining = num_players;
+        view.properties = properties.data();
+        view.num_properties = NUM_PROPERTIES;
+        view.owed = owed;
+        return view;
+    };
+};
+
+static_assert(std::is_trivially_copyable_v<GameState>, "GameState must clone with a plain copy");
+static_assert(offsetof(GameState, developed_mask) + sizeof(uint32_t) - offsetof(GameState, owner) <= 64,
+              "hot property state must fit one cache line");
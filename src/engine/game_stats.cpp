@@ -0,0 +1,94 @@
+#include "game_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STATS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define STATS_TSC 1
+#else
+#define STATS_TSC 0
+#endif
+
+namespace {
+uint64_t steady_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Ticks per nanosecond, measured once against steady_clock
+double ticks_per_ns() {
+#if STATS_TSC
+    static const double rate = [] {
+        const uint64_t ns = steady_ns();
+        const uint64_t ticks = stats_ticks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        const uint64_t elapsed_ns = steady_ns() - ns;
+        return elapsed_ns > 0 ? static_cast<double>(stats_ticks() - ticks) / static_cast<double>(elapsed_ns) : 1.0;
+    }();
+    return rate;
+#else
+    return 1.0;
+#endif
+}
+}
+
+const char* phase_name(Phase phase) {
+    switch (phase) {
+    case Phase::DICE: return "dice";
+    case Phase::HANDLE_POSITION: return "handle_position";
+    case Phase::CARD_DRAW: return "card_draw";
+    case Phase::RAISE_FUND: return "raise_fund";
+    case Phase::AUCTION: return "auction";
+    case Phase::TRADE: return "trade";
+    case Phase::AGENT_TURN: return "agent_turn";
+    case Phase::AGENT_AUCTION: return "agent_auction";
+    case Phase::AGENT_TRADE: return "agent_trade";
+    }
+    return "unknown";
+}
+
+uint64_t stats_ticks() {
+#if STATS_TSC
+    return __rdtsc();
+#else
+    return steady_ns();
+#endif
+}
+
+uint64_t stats_ticks_to_ns(uint64_t ticks) {
+    return static_cast<uint64_t>(static_cast<double>(ticks) / ticks_per_ns());
+}
+
+void GameStats::merge(const GameStats& other) {
+    games += other.games;
+    total_ns += other.total_ns;
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+        phases[i].calls += other.phases[i].calls;
+        phases[i].ns += other.phases[i].ns;
+    }
+    for (const AgentLatency& latency : other.agents) {
+        auto same = std::find_if(agents.begin(), agents.end(), [&](const AgentLatency& a) { return a.name == latency.name; });
+        if (same == agents.end()) {
+            agents.push_back(latency);
+            continue;
+        }
+        for (size_t call = 0; call < NUM_AGENT_CALLS; call++) {
+            same->calls[call].merge(latency.calls[call]);
+        }
+    }
+}
+
+GameStats PhaseCounters::finish() const {
+    GameStats stats;
+    stats.games = 1;
+    stats.total_ns = stats_ticks_to_ns(stats_ticks() - start);
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+        stats.phases[i].calls = calls[i];
+        stats.phases[i].ns = stats_ticks_to_ns(ticks[i]);
+    }
+    return stats;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "agent_adapter.h"
+
+// Parts of a game timed when its config asks for stats. Phases nest: handle_position includes the
+// card draws, raise_fund and auctions it leads to, and the agent phases the agent's own time.
+enum class Phase : uint8_t {
+    DICE,
+    HANDLE_POSITION,
+    CARD_DRAW,
+    RAISE_FUND,
+    AUCTION,
+    TRADE,
+    AGENT_TURN, // AgentAdapter / Policy calls
+    AGENT_AUCTION,
+    AGENT_TRADE,
+};
+
+constexpr size_t NUM_PHASES = 9;
+
+const char* phase_name(Phase phase);
+
+struct PhaseStats {
+    uint64_t calls = 0;
+    uint64_t ns = 0;
+};
+
+// Per-phase counts and times of one game, or summed over several
+struct GameStats {
+    uint64_t games = 0;
+    uint64_t total_ns = 0; // whole of Engine::run
+    std::array<PhaseStats, NUM_PHASES> phases{};
+    std::vector<AgentLatency> agents; // per seat in a game, per agent name once merged
+
+    const PhaseStats& operator[](Phase phase) const {
+        return phases[static_cast<size_t>(phase)];
+    };
+    void merge(const GameStats& other);
+};
+
+// Time stamp counter where there is one, else steady_clock nanoseconds
+uint64_t stats_ticks();
+uint64_t stats_ticks_to_ns(uint64_t ticks);
+
+// Raw counts of a running game, in ticks. Turned into a GameStats once the game ends.
+struct PhaseCounters {
+    uint64_t start = stats_ticks();
+    std::array<uint64_t, NUM_PHASES> calls{};
+    std::array<uint64_t, NUM_PHASES> ticks{};
+
+    GameStats finish() const;
+};
+
+// Adds its lifetime to a phase. With no counters (stats off) it costs a null check.
+class PhaseTimer {
+public:
+    PhaseTimer(PhaseCounters* counters, Phase phase)
+        : counters_(counters), phase_(phase), start_(counters ? stats_ticks() : 0) {}
+    ~PhaseTimer() {
+        if (counters_) {
+            counters_->calls[static_cast<size_t>(phase_)]++;
+            counters_->ticks[static_cast<size_t>(phase_)] += stats_ticks() - start_;
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    PhaseCounters* counters_;
+    Phase phase_;
+    uint64_t start_;
+};
@@ -0,0 +1,241 @@
+#include "json_reader.h"
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : text_(text) {}
+
+    JsonValue parse_document() {
+        JsonValue value = parse_value();
+        skip_whitespace();
+        if (pos_ != text_.size()) {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const char* reason) const {
+        throw std::runtime_error(std::string("JSON parse error at offset ") + std::to_string(pos_) + ": " + reason);
+    }
+
+    void skip_whitespace() {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                break;
+            }
+            pos_++;
+        }
+    }
+
+    char peek() {
+        skip_whitespace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+        return text_[pos_];
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            fail("unexpected character");
+        }
+        pos_++;
+    }
+
+    void expect_literal(std::string_view literal) {
+        if (text_.substr(pos_, literal.size()) != literal) {
+            fail("invalid literal");
+        }
+        pos_ += literal.size();
+    }
+
+    JsonValue parse_value() {
+        JsonValue value;
+        switch (peek()) {
+        case '{':
+            parse_object(value);
+            break;
+        case '[':
+            parse_array(value);
+            break;
+        case '"':
+            value.type = JsonValue::Type::String;
+            value.text = parse_string();
+            break;
+        case 't':
+            expect_literal("true");
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            break;
+        case 'f':
+            expect_literal("false");
+            value.type = JsonValue::Type::Bool;
+            break;
+        case 'n':
+            expect_literal("null");
+            break;
+        default:
+            parse_number(value);
+            break;
+        }
+        return value;
+    }
+
+    void parse_object(JsonValue& value) {
+        size_t start = pos_;
+        value.type = JsonValue::Type::Object;
+        expect('{');
+        if (peek() == '}') {
+            pos_++;
+        } else {
+            while (true) {
+                if (peek() != '"') {
+                    fail("expected object key");
+                }
+                std::string key = parse_string();
+                expect(':');
+                value.members.emplace_back(std::move(key), parse_value());
+                char c = peek();
+                pos_++;
+                if (c == '}') {
+                    break;
+                }
+                if (c != ',') {
+                    fail("expected ',' or '}'");
+                }
+            }
+        }
+        value.text = std::string(text_.substr(start, pos_ - start));
+    }
+
+    void parse_array(JsonValue& value) {
+        size_t start = pos_;
+        value.type = JsonValue::Type::Array;
+        expect('[');
+        if (peek() == ']') {
+            pos_++;
+        } else {
+            while (true) {
+                value.items.push_back(parse_value());
+                char c = peek();
+                pos_++;
+                if (c == ']') {
+                    break;
+                }
+                if (c != ',') {
+                    fail("expected ',' or ']'");
+                }
+            }
+        }
+        value.text = std::string(text_.substr(start, pos_ - start));
+    }
+
+    void parse_number(JsonValue& value) {
+        size_t start = pos_;
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+                pos_++;
+            } else {
+                break;
+            }
+        }
+        if (start == pos_) {
+            fail("unexpected character");
+        }
+        value.type = JsonValue::Type::Number;
+        value.text = std::string(text_.substr(start, pos_ - start));
+    }
+
+    std::string parse_string() {
+        expect('"');
+        std::string out;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            char c = text_[pos_++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                fail("unterminated escape");
+            }
+            char e = text_[pos_++];
+            switch (e) {
+            case '"':  out += '"';  break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/';  break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u': {
+                if (pos_ + 4 > text_.size()) {
+                    fail("truncated unicode escape");
+                }
+                unsigned int code = 0;
+                auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, code, 16);
+                if (ec != std::errc() || ptr != text_.data() + pos_ + 4) {
+                    fail("invalid unicode escape");
+                }
+                pos_ += 4;
+                // Paths and names are expected to be ASCII, encode the BMP code point as UTF-8
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                fail("invalid escape");
+            }
+        }
+    }
+};
+}
+
+const JsonValue* JsonValue::find(std::string_view key) const {
+    if (type != Type::Object) {
+        return nullptr;
+    }
+    for (const auto& member : members) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t JsonValue::as_u64(const char* what) const {
+    uint64_t value = 0;
+    if (type == Type::Number) {
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value, 10);
+        if (ec == std::errc() && ptr == text.data() + text.size()) {
+            return value;
+        }
+    }
+    throw std::runtime_error(std::string("Invalid ") + what + ": expected non-negative integer");
+}
+
+JsonValue parse_json(std::string_view text) {
+    return JsonParser(text).parse_document();
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Minimal JSON reader for game manifests, not a general purpose parser.
+// Numbers keep their source text so 64-bit seeds survive without a round trip through double.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    std::string text; // string contents, number literal, or raw source of an array/object
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    bool is_object() const { return type == Type::Object; };
+    bool is_array() const { return type == Type::Array; };
+    bool is_string() const { return type == Type::String; };
+
+    // nullptr if this is not an object or the key is missing
+    const JsonValue* find(std::string_view key) const;
+
+    // Throws std::runtime_error naming `what` if the value is not a non-negative integer
+    uint64_t as_u64(const char* what) const;
+};
+
+// Throws std::runtime_error on malformed input
+JsonValue parse_json(std::string_view text);
@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Log-bucketed latencies: exact below 16ns, then 4 buckets per power of two (at most 19% wide)
+// up to 2^44ns. Quantiles report the upper edge of their bucket, capped at the largest sample.
+struct LatencyHistogram {
+    static constexpr uint32_t LINEAR = 16;
+    static constexpr uint32_t SUB_BUCKETS = 4;
+    static constexpr uint32_t MAX_OCTAVE = 43;
+    static constexpr uint32_t NUM_BUCKETS = LINEAR + (MAX_OCTAVE - 3) * SUB_BUCKETS;
+
+    std::array<uint32_t, NUM_BUCKETS> buckets{};
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+
+    static uint32_t bucket_of(uint64_t ns) {
+        if (ns < LINEAR) {
+            return static_cast<uint32_t>(ns);
+        }
+        const uint32_t octave = std::min<uint32_t>(std::bit_width(ns) - 1, MAX_OCTAVE);
+        const uint32_t sub = static_cast<uint32_t>(ns >> (octave - 2)) & (SUB_BUCKETS - 1);
+        return LINEAR + (octave - 4) * SUB_BUCKETS + sub;
+    };
+
+    // Largest ns that lands in bucket
+    static uint64_t bucket_limit(uint32_t bucket) {
+        if (bucket < LINEAR) {
+            return bucket;
+        }
+        const uint32_t octave = (bucket - LINEAR) / SUB_BUCKETS + 4;
+        const uint64_t sub = (bucket - LINEAR) % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << (octave - 2)) - 1;
+    };
+
+    void record(uint64_t ns) {
+        buckets[bucket_of(ns)]++;
+        calls++;
+        total_ns += ns;
+        max_ns = std::max(max_ns, ns);
+    };
+
+    // q in [0, 1], 0 with no calls
+    uint64_t quantile(double q) const {
+        if (calls == 0) {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(calls) + 0.5));
+        uint64_t seen = 0;
+        for (uint32_t bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+            seen += buckets[bucket];
+            if (seen >= rank) {
+                return std::min(bucket_limit(bucket), max_ns);
+            }
+        }
+        return max_ns;
+    };
+
+    void merge(const LatencyHistogram& other) {
+        for (uint32_t bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+            buckets[bucket] += other.buckets[bucket];
+        }
+        calls += other.calls;
+        total_ns += other.total_ns;
+        max_ns = std::max(max_ns, other.max_ns);
+    };
+};
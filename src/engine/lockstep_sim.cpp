@@ -0,0 +1,1018 @@
+#include "lockstep_sim.h"
+#include "board.hpp"
+#include "rng.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LOCKSTEP_AVX2 1
+#include <immintrin.h>
+#else
+#define LOCKSTEP_AVX2 0
+#endif
+
+namespace {
+constexpr uint32_t WIDTH = 8; // lanes per AVX2 vector
+constexpr uint32_t NUM_PROPERTIES = GameState::NUM_PROPERTIES;
+constexpr int32_t STARTING_CASH = 1500;
+constexpr int32_t GO_SALARY = 200;
+constexpr int32_t TAX = 200;
+constexpr int32_t JAIL_FINE = 50;
+constexpr int32_t FREE = -1; // jail_ of a player not in jail, else turns spent there
+constexpr int32_t HOTEL = GameState::HOTEL;
+constexpr uint32_t COMMUNITY_CARD = 1; // jail card bits
+constexpr uint32_t CHANCE_CARD = 2;
+
+enum TileKind : int32_t {
+    KIND_NONE,
+    KIND_OWNABLE,
+    KIND_TAX,
+    KIND_CARD,
+    KIND_GO_TO_JAIL,
+};
+
+enum class Landing {
+    ROLL,
+    CARD, // moved by a card, no further card drawn
+    RAILROAD_CARD, // double rent
+    UTILITY_CARD, // 10x the roll
+};
+
+// Board lookups widened to int32 for gathers
+struct Tables {
+    std::array<int32_t, 40> kind{};
+    std::array<int32_t, 40> ownable{}; // 0 off ownables, kind tells them apart
+    std::array<int32_t, 40> utility{}; // -1 on utilities, whose rent is a multiplier of the roll
+    std::array<std::array<int32_t, 6>, NUM_PROPERTIES> street_rent{};
+    int32_t jail = 0;
+};
+
+const Tables& tables() {
+    static const Tables t = [] {
+        const Board& b = board();
+        Tables t;
+        for (uint32_t tile = 0; tile < 40; tile++) {
+            switch (b.tiles[tile].type) {
+            case TileType::Property:
+            case TileType::Railroad:
+            case TileType::Utility:
+                t.kind[tile] = KIND_OWNABLE;
+                break;
+            case TileType::Tax:
+                t.kind[tile] = KIND_TAX;
+                break;
+            case TileType::Chance:
+            case TileType::Community:
+                t.kind[tile] = KIND_CARD;
+                break;
+            case TileType::GoToJail:
+                t.kind[tile] = KIND_GO_TO_JAIL;
+                break;
+            case TileType::Jail:
+                t.jail = static_cast<int32_t>(tile);
+                break;
+            default:
+                break;
+            }
+            t.ownable[tile] = std::max<int32_t>(b.ownableByTile(tile), 0);
+            t.utility[tile] = b.tiles[tile].type == TileType::Utility ? -1 : 0;
+        }
+        for (uint32_t index = 0; index < NUM_PROPERTIES; index++) {
+            if (const PropertyInfo* street = b.propertyByTile(b.ownables[index].tile)) {
+                std::copy(street->rent.begin(), street->rent.end(), t.street_rent[index].begin());
+            }
+        }
+        return t;
+    }();
+    return t;
+}
+
+// First of positions past tile, going round the board
+template <size_t N>
+int32_t next_of(const std::array<int8_t, N>& positions, int32_t tile) {
+    for (int8_t position : positions) {
+        if (position > tile) {
+            return position;
+        }
+    }
+    return positions[0];
+}
+
+#if LOCKSTEP_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 inline __m256i load8(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+AVX2 inline __m256i load8(const uint32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+AVX2 inline void store8(int32_t* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+AVX2 inline void store8(uint32_t* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+AVX2 inline __m256i rotl8(__m256i v, int k) {
+    return _mm256_or_si256(_mm256_slli_epi32(v, k), _mm256_srli_epi32(v, 32 - k));
+}
+AVX2 inline uint32_t lane_bits(__m256i mask) {
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+#endif
+
+class LockstepSim {
+public:
+    LockstepSim(const LockstepConfig& config, uint64_t first_game, uint64_t end_game, uint32_t lanes, bool simd);
+    void run(LockstepStats& stats);
+
+private:
+    size_t at(uint32_t row, uint32_t lane) const {
+        return static_cast<size_t>(row) * lanes_ + lane;
+    };
+
+    uint32_t next(uint32_t lane);
+    void start_game(uint32_t lane);
+    void end_round(LockstepStats& stats);
+    uint64_t step_scalar(uint32_t seat);
+#if LOCKSTEP_AVX2
+    AVX2 uint64_t step_avx2(uint32_t seat);
+#endif
+
+    void take_turn(uint32_t lane, uint32_t seat);
+    void after_turn(uint32_t lane, uint32_t seat);
+    bool move(uint32_t lane, uint32_t seat, int32_t d1, int32_t d2);
+    void land(uint32_t lane, uint32_t seat, int32_t total, Landing how);
+    void jail_turn(uint32_t lane, uint32_t seat);
+    void send_to_jail(uint32_t lane, uint32_t seat);
+    void advance_to(uint32_t lane, uint32_t seat, int32_t tile);
+    void collect_from_each(uint32_t lane, uint32_t seat, int32_t amount);
+    void community_card(uint32_t lane, uint32_t seat);
+    void chance_card(uint32_t lane, uint32_t seat, int32_t total);
+    int32_t repairs(uint32_t lane, uint32_t seat, int32_t per_house, int32_t per_hotel);
+
+    void pay_bank(uint32_t lane, uint32_t seat, int32_t amount);
+    void pay_player(uint32_t lane, uint32_t seat, uint32_t creditor, int32_t amount);
+    bool raise(uint32_t lane, uint32_t seat, int32_t amount);
+    void bankrupt(uint32_t lane, uint32_t seat, int32_t creditor);
+    void buy(uint32_t lane, uint32_t seat, uint32_t index);
+    void develop(uint32_t lane, uint32_t seat);
+    void refresh_rents(uint32_t lane);
+
+    const Tables& tables_;
+    const Board& board_;
+    std::vector<LockstepPolicy> seats_;
+    uint32_t num_seats_;
+    uint32_t max_turns_;
+    uint64_t seed_;
+    uint64_t next_game_;
+    uint64_t end_game_;
+    uint32_t lanes_;
+    bool simd_;
+
+    // Per lane
+    std::vector<int32_t> live_; // -1 while the lane plays a game
+    std::vector<int32_t> rounds_;
+    std::vector<int32_t> alive_;
+    std::vector<int32_t> houses_left_;
+    std::vector<int32_t> hotels_left_;
+    std::vector<uint32_t> jail_cards_out_; // COMMUNITY_CARD / CHANCE_CARD held by a player
+    std::vector<uint32_t> rng_; // xoshiro128** words, [word][lane]
+
+    // [seat][lane]
+    std::vector<int32_t> position_;
+    std::vector<int32_t> cash_;
+    std::vector<int32_t> doubles_;
+    std::vector<int32_t> jail_;
+    std::vector<int32_t> retired_; // -1 once bankrupt
+    std::vector<uint32_t> jail_cards_; // COMMUNITY_CARD / CHANCE_CARD bits
+    std::vector<uint32_t> owned_; // property bitmask
+    std::vector<uint32_t> monopolies_; // colour bitmask, whole group owned and unmortgaged
+
+    // [property][lane]
+    std::vector<int32_t> owner_; // -1 for none
+    std::vector<int32_t> houses_; // HOTEL for a hotel
+    std::vector<int32_t> mortgaged_;
+    std::vector<int32_t> rent_; // what landing costs, a multiplier of the roll on utilities
+};
+
+LockstepSim::LockstepSim(const LockstepConfig& config, uint64_t first_game, uint64_t end_game, uint32_t lanes, bool simd)
+    : tables_(tables()), board_(board()), seats_(config.seats), num_seats_(static_cast<uint32_t>(config.seats.size())),
+      max_turns_(config.max_turns), seed_(config.seed), next_game_(first_game), end_game_(end_game), lanes_(lanes),
+      simd_(simd), live_(lanes), rounds_(lanes), alive_(lanes), houses_left_(lanes), hotels_left_(lanes),
+      jail_cards_out_(lanes), rng_(4 * lanes), position_(num_seats_ * lanes), cash_(num_seats_ * lanes),
+      doubles_(num_seats_ * lanes), jail_(num_seats_ * lanes), retired_(num_seats_ * lanes),
+      jail_cards_(num_seats_ * lanes), owned_(num_seats_ * lanes), monopolies_(num_seats_ * lanes),
+      owner_(NUM_PROPERTIES * lanes), houses_(NUM_PROPERTIES * lanes), mortgaged_(NUM_PROPERTIES * lanes),
+      rent_(NUM_PROPERTIES * lanes) {}
+
+void LockstepSim::run(LockstepStats& stats) {
+    for (uint32_t lane = 0; lane < lanes_; lane++) {
+        this->start_game(lane);
+    }
+    while (std::any_of(live_.begin(), live_.end(), [](int32_t live) { return live != 0; })) {
+        for (uint32_t seat = 0; seat < num_seats_; seat++) {
+#if LOCKSTEP_AVX2
+            stats.player_turns += simd_ ? this->step_avx2(seat) : this->step_scalar(seat);
+#else
+            stats.player_turns += this->step_scalar(seat);
+#endif
+        }
+        this->end_round(stats);
+    }
+}
+
+// xoshiro128**, one generator per lane
+uint32_t LockstepSim::next(uint32_t lane) {
+    uint32_t& s0 = rng_[at(0, lane)];
+    uint32_t& s1 = rng_[at(1, lane)];
+    uint32_t& s2 = rng_[at(2, lane)];
+    uint32_t& s3 = rng_[at(3, lane)];
+    const uint32_t result = std::rotl(s1 * 5, 7) * 9;
+    const uint32_t t = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = std::rotl(s3, 11);
+    return result;
+}
+
+void LockstepSim::start_game(uint32_t lane) {
+    if (next_game_ >= end_game_) {
+        live_[lane] = 0;
+        return;
+    }
+    uint64_t state = derive_seed(seed_, next_game_++);
+    for (uint32_t word = 0; word < 4; word += 2) {
+        const uint64_t bits = splitmix64(state);
+        rng_[at(word, lane)] = static_cast<uint32_t>(bits);
+        rng_[at(word + 1, lane)] = static_cast<uint32_t>(bits >> 32);
+    }
+
+    for (uint32_t seat = 0; seat < num_seats_; seat++) {
+        const size_t s = at(seat, lane);
+        position_[s] = 0;
+        cash_[s] = STARTING_CASH;
+        doubles_[s] = 0;
+        jail_[s] = FREE;
+        retired_[s] = 0;
+        jail_cards_[s] = 0;
+        owned_[s] = 0;
+        monopolies_[s] = 0;
+    }
+    for (uint32_t index = 0; index < NUM_PROPERTIES; index++) {
+        const size_t p = at(index, lane);
+        owner_[p] = -1;
+        houses_[p] = 0;
+        mortgaged_[p] = 0;
+        rent_[p] = 0;
+    }
+    live_[lane] = -1;
+    rounds_[lane] = 0;
+    alive_[lane] = static_cast<int32_t>(num_seats_);
+    houses_left_[lane] = 32;
+    hotels_left_[lane] = 12;
+    jail_cards_out_[lane] = 0;
+}
+
+// Games end between rounds, like Engine::game_over
+void LockstepSim::end_round(LockstepStats& stats) {
+    for (uint32_t lane = 0; lane < lanes_; lane++) {
+        if (!live_[lane]) {
+            continue;
+        }
+        rounds_[lane]++;
+        if (alive_[lane] > 1 && static_cast<uint32_t>(rounds_[lane]) < max_turns_) {
+            continue;
+        }
+        stats.games++;
+        stats.rounds += rounds_[lane];
+        if (alive_[lane] == 1 && static_cast<uint32_t>(rounds_[lane]) < max_turns_) {
+            for (uint32_t seat = 0; seat < num_seats_; seat++) {
+                if (!retired_[at(seat, lane)]) {
+                    stats.wins[seat]++;
+                }
+            }
+        } else {
+            stats.draws++;
+        }
+        this->start_game(lane);
+    }
+}
+
+uint64_t LockstepSim::step_scalar(uint32_t seat) {
+    uint64_t turns = 0;
+    for (uint32_t lane = 0; lane < lanes_; lane++) {
+        if (!live_[lane] || retired_[at(seat, lane)]) {
+            continue;
+        }
+        turns++;
+        this->take_turn(lane, seat);
+        this->after_turn(lane, seat);
+    }
+    return turns;
+}
+
+#if LOCKSTEP_AVX2
+// step_scalar on 8 lanes at once. Lanes in jail, or whose landing needs a decision, a card or
+// funds raised, finish the turn in the scalar code; everything else is masked vector arithmetic.
+AVX2 uint64_t LockstepSim::step_avx2(uint32_t seat) {
+    const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i none = _mm256_set1_epi32(-1);
+    const __m256i low16 = _mm256_set1_epi32(0xffff);
+    const __m256i six = _mm256_set1_epi32(6);
+    const __m256i last_tile = _mm256_set1_epi32(39);
+    const __m256i board_size = _mm256_set1_epi32(40);
+    const __m256i jail_tile = _mm256_set1_epi32(tables_.jail);
+    const __m256i this_seat = _mm256_set1_epi32(static_cast<int32_t>(seat));
+    const __m256i stride = _mm256_set1_epi32(static_cast<int32_t>(lanes_));
+
+    uint64_t turns = 0;
+    alignas(32) int32_t totals[WIDTH];
+    for (uint32_t base = 0; base < lanes_; base += WIDTH) {
+        const size_t s = at(seat, base);
+        const __m256i playing = _mm256_andnot_si256(load8(&retired_[s]), load8(&live_[base]));
+        __m256i jail = load8(&jail_[s]);
+        const __m256i fast = _mm256_and_si256(playing, _mm256_cmpeq_epi32(jail, none));
+        const uint32_t playing_bits = lane_bits(playing);
+        const uint32_t fast_bits = lane_bits(fast);
+        uint32_t slow_bits = 0;
+
+        if (fast_bits) {
+            // Dice, from the same generator step and bits as next() and take_turn()
+            __m256i w0 = load8(&rng_[at(0, base)]);
+            __m256i w1 = load8(&rng_[at(1, base)]);
+            __m256i w2 = load8(&rng_[at(2, base)]);
+            __m256i w3 = load8(&rng_[at(3, base)]);
+            const __m256i r = _mm256_mullo_epi32(rotl8(_mm256_mullo_epi32(w1, _mm256_set1_epi32(5)), 7), _mm256_set1_epi32(9));
+            const __m256i t = _mm256_slli_epi32(w1, 9);
+            const __m256i n2 = _mm256_xor_si256(w2, w0);
+            const __m256i n3 = _mm256_xor_si256(w3, w1);
+            const __m256i n1 = _mm256_xor_si256(w1, n2);
+            const __m256i n0 = _mm256_xor_si256(w0, n3);
+            store8(&rng_[at(0, base)], _mm256_blendv_epi8(w0, n0, fast));
+            store8(&rng_[at(1, base)], _mm256_blendv_epi8(w1, n1, fast));
+            store8(&rng_[at(2, base)], _mm256_blendv_epi8(w2, _mm256_xor_si256(n2, t), fast));
+            store8(&rng_[at(3, base)], _mm256_blendv_epi8(w3, rotl8(n3, 11), fast));
+
+            const __m256i d1 = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(r, low16), six), 16), one);
+            const __m256i d2 = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(r, 16), six), 16), one);
+            const __m256i total = _mm256_add_epi32(d1, d2);
+            const __m256i rolled_double = _mm256_cmpeq_epi32(d1, d2);
+
+            // Third double in a row goes to jail without moving
+            __m256i doubles = load8(&doubles_[s]);
+            const __m256i third = _mm256_and_si256(fast, _mm256_and_si256(rolled_double, _mm256_cmpgt_epi32(doubles, one)));
+            const __m256i moving = _mm256_andnot_si256(third, fast);
+
+            __m256i position = load8(&position_[s]);
+            __m256i cash = load8(&cash_[s]);
+            __m256i target = _mm256_add_epi32(position, total);
+            const __m256i wrapped = _mm256_cmpgt_epi32(target, last_tile);
+            target = _mm256_sub_epi32(target, _mm256_and_si256(wrapped, board_size));
+            cash = _mm256_add_epi32(cash, _mm256_and_si256(_mm256_and_si256(wrapped, moving), _mm256_set1_epi32(GO_SALARY)));
+
+            const __m256i kind = _mm256_mask_i32gather_epi32(zero, tables_.kind.data(), target, moving, 4);
+            const __m256i to_jail = _mm256_or_si256(third, _mm256_and_si256(moving, _mm256_cmpeq_epi32(kind, _mm256_set1_epi32(KIND_GO_TO_JAIL))));
+            target = _mm256_blendv_epi8(target, jail_tile, to_jail);
+            jail = _mm256_blendv_epi8(jail, zero, to_jail);
+            __m256i next_doubles = _mm256_andnot_si256(to_jail, _mm256_and_si256(rolled_double, _mm256_add_epi32(doubles, one)));
+            doubles = _mm256_blendv_epi8(doubles, next_doubles, fast);
+            position = _mm256_blendv_epi8(position, target, fast);
+
+            const __m256i tax = _mm256_and_si256(moving, _mm256_cmpeq_epi32(kind, _mm256_set1_epi32(KIND_TAX)));
+            const __m256i can_pay_tax = _mm256_cmpgt_epi32(cash, _mm256_set1_epi32(TAX - 1));
+            cash = _mm256_sub_epi32(cash, _mm256_and_si256(_mm256_and_si256(tax, can_pay_tax), _mm256_set1_epi32(TAX)));
+            __m256i slow = _mm256_andnot_si256(can_pay_tax, tax);
+            slow = _mm256_or_si256(slow, _mm256_and_si256(moving, _mm256_cmpeq_epi32(kind, _mm256_set1_epi32(KIND_CARD))));
+
+            const __m256i ownable = _mm256_and_si256(moving, _mm256_cmpeq_epi32(kind, _mm256_set1_epi32(KIND_OWNABLE)));
+            __m256i paid = zero;
+            __m256i owner = none;
+            __m256i rent = zero;
+            if (!_mm256_testz_si256(ownable, ownable)) {
+                const __m256i index = _mm256_mask_i32gather_epi32(zero, tables_.ownable.data(), target, ownable, 4);
+                const __m256i slot = _mm256_add_epi32(_mm256_mullo_epi32(index, stride), _mm256_add_epi32(_mm256_set1_epi32(static_cast<int32_t>(base)), iota));
+                owner = _mm256_mask_i32gather_epi32(none, owner_.data(), slot, ownable, 4);
+                rent = _mm256_mask_i32gather_epi32(zero, rent_.data(), slot, ownable, 4);
+                const __m256i utility = _mm256_mask_i32gather_epi32(zero, tables_.utility.data(), target, ownable, 4);
+                rent = _mm256_blendv_epi8(rent, _mm256_mullo_epi32(rent, total), utility);
+
+                // Unowned needs a buying decision
+                slow = _mm256_or_si256(slow, _mm256_and_si256(ownable, _mm256_cmpgt_epi32(zero, owner)));
+                const __m256i owes = _mm256_and_si256(_mm256_and_si256(ownable, _mm256_cmpgt_epi32(owner, none)),
+                                                      _mm256_andnot_si256(_mm256_cmpeq_epi32(owner, this_seat), _mm256_cmpgt_epi32(rent, zero)));
+                const __m256i can_pay = _mm256_cmpgt_epi32(cash, _mm256_sub_epi32(rent, one));
+                slow = _mm256_or_si256(slow, _mm256_andnot_si256(can_pay, owes));
+                paid = _mm256_and_si256(owes, can_pay);
+                cash = _mm256_sub_epi32(cash, _mm256_and_si256(paid, rent));
+            }
+
+            store8(&position_[s], position);
+            store8(&doubles_[s], doubles);
+            store8(&jail_[s], jail);
+            store8(&cash_[s], cash);
+            if (!_mm256_testz_si256(paid, paid)) {
+                for (uint32_t other = 0; other < num_seats_; other++) {
+                    if (other == seat) {
+                        continue;
+                    }
+                    const __m256i credit = _mm256_and_si256(_mm256_and_si256(paid, _mm256_cmpeq_epi32(owner, _mm256_set1_epi32(static_cast<int32_t>(other)))), rent);
+                    int32_t* other_cash = &cash_[at(other, base)];
+                    store8(other_cash, _mm256_add_epi32(load8(other_cash), credit));
+                }
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(totals), total);
+            slow_bits = lane_bits(slow);
+        }
+
+        turns += std::popcount(playing_bits);
+        for (uint32_t bits = playing_bits; bits; bits &= bits - 1) {
+            const uint32_t offset = std::countr_zero(bits);
+            const uint32_t lane = base + offset;
+            if (!(fast_bits >> offset & 1)) {
+                this->take_turn(lane, seat);
+            } else if (slow_bits >> offset & 1) {
+                this->land(lane, seat, totals[offset], Landing::ROLL);
+            }
+            this->after_turn(lane, seat);
+        }
+    }
+    return turns;
+}
+#endif
+
+void LockstepSim::take_turn(uint32_t lane, uint32_t seat) {
+    if (jail_[at(seat, lane)] != FREE) {
+        this->jail_turn(lane, seat);
+        return;
+    }
+    const uint32_t r = this->next(lane);
+    const int32_t d1 = static_cast<int32_t>(((r & 0xffff) * 6) >> 16) + 1;
+    const int32_t d2 = static_cast<int32_t>(((r >> 16) * 6) >> 16) + 1;
+    if (this->move(lane, seat, d1, d2)) {
+        this->land(lane, seat, d1 + d2, Landing::ROLL);
+    }
+}
+
+void LockstepSim::after_turn(uint32_t lane, uint32_t seat) {
+    if (!retired_[at(seat, lane)] && seats_[seat] == LockstepPolicy::HEURISTIC) {
+        this->develop(lane, seat);
+    }
+}
+
+// Like Engine::update_position: a third double in a row, across turns, jails instead of moving
+bool LockstepSim::move(uint32_t lane, uint32_t seat, int32_t d1, int32_t d2) {
+    const size_t s = at(seat, lane);
+    if (d1 == d2) {
+        if (doubles_[s] >= 2) {
+            this->send_to_jail(lane, seat);
+            return false;
+        }
+        doubles_[s]++;
+    } else {
+        doubles_[s] = 0;
+    }
+    position_[s] += d1 + d2;
+    if (position_[s] >= 40) {
+        position_[s] -= 40;
+        cash_[s] += GO_SALARY;
+    }
+    return true;
+}
+
+void LockstepSim::land(uint32_t lane, uint32_t seat, int32_t total, Landing how) {
+    const size_t s = at(seat, lane);
+    const int32_t tile = position_[s];
+    switch (tables_.kind[tile]) {
+    case KIND_GO_TO_JAIL:
+        this->send_to_jail(lane, seat);
+        break;
+    case KIND_TAX:
+        this->pay_bank(lane, seat, TAX);
+        break;
+    case KIND_CARD:
+        if (how != Landing::ROLL) {
+            break;
+        }
+        if (board_.tiles[tile].type == TileType::Chance) {
+            this->chance_card(lane, seat, total);
+        } else {
+            this->community_card(lane, seat);
+        }
+        break;
+    case KIND_OWNABLE: {
+        const uint32_t index = static_cast<uint32_t>(tables_.ownable[tile]);
+        const int32_t owner = owner_[at(index, lane)];
+        if (owner < 0) {
+            const int32_t price = board_.ownables[index].purchase_price;
+            bool buying = false;
+            switch (seats_[seat]) {
+            case LockstepPolicy::RANDOM:
+                buying = cash_[s] >= price && (this->next(lane) >> 31) != 0;
+                break;
+            case LockstepPolicy::GREEDY:
+                buying = cash_[s] >= price + 100;
+                break;
+            case LockstepPolicy::HEURISTIC:
+                buying = cash_[s] >= price + 150;
+                break;
+            }
+            if (buying) {
+                this->buy(lane, seat, index);
+            }
+            break;
+        }
+        if (owner == static_cast<int32_t>(seat)) {
+            break;
+        }
+        int32_t rent = rent_[at(index, lane)];
+        if (tables_.utility[tile]) {
+            rent = (how == Landing::UTILITY_CARD && rent > 0 ? 10 : rent) * total;
+        } else if (how == Landing::RAILROAD_CARD) {
+            rent *= 2;
+        }
+        if (rent > 0) {
+            this->pay_player(lane, seat, static_cast<uint32_t>(owner), rent);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// GREEDY leaves at once if it can; otherwise roll for doubles, and pay the fine after a third miss
+void LockstepSim::jail_turn(uint32_t lane, uint32_t seat) {
+    const size_t s = at(seat, lane);
+    if (seats_[seat] == LockstepPolicy::GREEDY && (jail_cards_[s] || cash_[s] >= JAIL_FINE)) {
+        if (jail_cards_[s]) {
+            const uint32_t card = jail_cards_[s] & (~jail_cards_[s] + 1);
+            jail_cards_[s] &= ~card;
+            jail_cards_out_[lane] &= ~card;
+        } else {
+            cash_[s] -= JAIL_FINE;
+        }
+        jail_[s] = FREE;
+        this->take_turn(lane, seat);
+        return;
+    }
+
+    const uint32_t r = this->next(lane);
+    const int32_t d1 = static_cast<int32_t>(((r & 0xffff) * 6) >> 16) + 1;
+    const int32_t d2 = static_cast<int32_t>(((r >> 16) * 6) >> 16) + 1;
+    if (d1 != d2) {
+        if (++jail_[s] < 3) {
+            return;
+        }
+        this->pay_bank(lane, seat, JAIL_FINE);
+        if (retired_[s]) {
+            return;
+        }
+    }
+    jail_[s] = FREE;
+    position_[s] += d1 + d2;
+    this->land(lane, seat, d1 + d2, Landing::ROLL);
+}
+
+void LockstepSim::send_to_jail(uint32_t lane, uint32_t seat) {
+    const size_t s = at(seat, lane);
+    position_[s] = tables_.jail;
+    jail_[s] = 0;
+    doubles_[s] = 0;
+}
+
+// Forward to tile, collecting Go salary on the way
+void LockstepSim::advance_to(uint32_t lane, uint32_t seat, int32_t tile) {
+    const size_t s = at(seat, lane);
+    if (tile < position_[s]) {
+        cash_[s] += GO_SALARY;
+    }
+    position_[s] = tile;
+}
+
+// Same cards as engine_cards.cpp
+void LockstepSim::community_card(uint32_t lane, uint32_t seat) {
+    const size_t s = at(seat, lane);
+    switch (this->next(lane) >> 28) {
+    case 0:
+        this->advance_to(lane, seat, 0);
+        break;
+    case 1:
+        cash_[s] += 200;
+        break;
+    case 2:
+    case 11:
+    case 12:
+        this->pay_bank(lane, seat, 50);
+        break;
+    case 3:
+        cash_[s] += 50;
+        break;
+    case 4:
+        if (!(jail_cards_out_[lane] & COMMUNITY_CARD)) {
+            jail_cards_out_[lane] |= COMMUNITY_CARD;
+            jail_cards_[s] |= COMMUNITY_CARD;
+        }
+        break;
+    case 5:
+        this->send_to_jail(lane, seat);
+        break;
+    case 6:
+        this->collect_from_each(lane, seat, 50);
+        break;
+    case 7:
+    case 10:
+        cash_[s] += 100;
+        break;
+    case 8:
+        cash_[s] += 20;
+        break;
+    case 9:
+        this->collect_from_each(lane, seat, 10);
+        break;
+    case 13:
+        cash_[s] += 25;
+        break;
+    case 14:
+        this->pay_bank(lane, seat, this->repairs(lane, seat, 40, 115));
+        break;
+    case 15:
+        cash_[s] += 10;
+        break;
+    }
+}
+
+void LockstepSim::chance_card(uint32_t lane, uint32_t seat, int32_t total) {
+    const size_t s = at(seat, lane);
+    switch (this->next(lane) >> 28) {
+    case 0:
+        this->advance_to(lane, seat, 39);
+        this->land(lane, seat, total, Landing::CARD);
+        break;
+    case 1:
+        this->advance_to(lane, seat, 0);
+        break;
+    case 2:
+        this->advance_to(lane, seat, 24);
+        this->land(lane, seat, total, Landing::CARD);
+        break;
+    case 3:
+        this->advance_to(lane, seat, 11);
+        this->land(lane, seat, total, Landing::CARD);
+        break;
+    case 4:
+    case 5:
+        this->advance_to(lane, seat, next_of(board_.railroad_positions, position_[s]));
+        this->land(lane, seat, total, Landing::RAILROAD_CARD);
+        break;
+    case 6:
+        this->advance_to(lane, seat, next_of(board_.utility_positions, position_[s]));
+        this->land(lane, seat, total, Landing::UTILITY_CARD);
+        break;
+    case 7:
+        cash_[s] += 50;
+        break;
+    case 8:
+        if (!(jail_cards_out_[lane] & CHANCE_CARD)) {
+            jail_cards_out_[lane] |= CHANCE_CARD;
+            jail_cards_[s] |= CHANCE_CARD;
+        }
+        break;
+    case 9:
+        position_[s] = (position_[s] + 37) % 40;
+        this->land(lane, seat, total, Landing::CARD);
+        break;
+    case 10:
+        this->send_to_jail(lane, seat);
+        break;
+    case 11:
+        this->pay_bank(lane, seat, this->repairs(lane, seat, 25, 100));
+        break;
+    case 12:
+        this->pay_bank(lane, seat, 15);
+        break;
+    case 13:
+        this->advance_to(lane, seat, 5);
+        this->land(lane, seat, total, Landing::CARD);
+        break;
+    case 14:
+        for (uint32_t other = 0; other < num_seats_ && !retired_[s]; other++) {
+            if (other != seat && !retired_[at(other, lane)]) {
+                this->pay_player(lane, seat, other, 50);
+            }
+        }
+        break;
+    case 15:
+        cash_[s] += 150;
+        break;
+    }
+}
+
+void LockstepSim::collect_from_each(uint32_t lane, uint32_t seat, int32_t amount) {
+    for (uint32_t other = 0; other < num_seats_; other++) {
+        if (other != seat && !retired_[at(other, lane)]) {
+            this->pay_player(lane, other, seat, amount);
+        }
+    }
+}
+
+int32_t LockstepSim::repairs(uint32_t lane, uint32_t seat, int32_t per_house, int32_t per_hotel) {
+    int32_t cost = 0;
+    for (uint32_t bits = owned_[at(seat, lane)]; bits; bits &= bits - 1) {
+        const int32_t houses = houses_[at(std::countr_zero(bits), lane)];
+        cost += houses == HOTEL ? per_hotel : houses * per_house;
+    }
+    return cost;
+}
+
+void LockstepSim::pay_bank(uint32_t lane, uint32_t seat, int32_t amount) {
+    if (this->raise(lane, seat, amount)) {
+        cash_[at(seat, lane)] -= amount;
+    } else {
+        this->bankrupt(lane, seat, -1);
+    }
+}
+
+void LockstepSim::pay_player(uint32_t lane, uint32_t seat, uint32_t creditor, int32_t amount) {
+    if (this->raise(lane, seat, amount)) {
+        cash_[at(seat, lane)] -= amount;
+        cash_[at(creditor, lane)] += amount;
+    } else {
+        this->bankrupt(lane, seat, static_cast<int32_t>(creditor));
+    }
+}
+
+// Mortgage the cheapest property of an undeveloped group, else sell a house off the most developed
+// street, until amount is covered. False if everything is gone and it still is not.
+bool LockstepSim::raise(uint32_t lane, uint32_t seat, int32_t amount) {
+    const size_t s = at(seat, lane);
+    bool changed = false;
+    while (cash_[s] < amount) {
+        int32_t cheapest = -1;
+        int32_t most_built = -1;
+        for (uint32_t bits = owned_[s]; bits; bits &= bits - 1) {
+            const uint32_t index = std::countr_zero(bits);
+            const size_t p = at(index, lane);
+            if (houses_[p] > 0 && (most_built < 0 || houses_[p] > houses_[at(most_built, lane)])) {
+                most_built = static_cast<int32_t>(index);
+            }
+            if (mortgaged_[p]) {
+                continue;
+            }
+            const OwnableInfo& info = board_.ownables[index];
+            bool developed = false;
+            for (uint32_t group = board_.colourMask(info.colour); group && info.colour != Colour::None; group &= group - 1) {
+                developed |= houses_[at(std::countr_zero(group), lane)] > 0;
+            }
+            if (!developed && (cheapest < 0 || info.purchase_price < board_.ownables[cheapest].purchase_price)) {
+                cheapest = static_cast<int32_t>(index);
+            }
+        }
+
+        if (cheapest >= 0) {
+            mortgaged_[at(cheapest, lane)] = -1;
+            cash_[s] += board_.ownables[cheapest].purchase_price / 2;
+        } else if (most_built >= 0) {
+            const size_t p = at(most_built, lane);
+            const int32_t house_cost = board_.ownables[most_built].house_cost;
+            if (houses_[p] < HOTEL) {
+                houses_[p]--;
+                houses_left_[lane]++;
+                cash_[s] += house_cost / 2;
+            } else if (houses_left_[lane] >= 4) {
+                houses_[p] = 4;
+                houses_left_[lane] -= 4;
+                hotels_left_[lane]++;
+                cash_[s] += house_cost / 2;
+            } else {
+                // No houses to break the hotel down with, sell it all
+                houses_[p] = 0;
+                hotels_left_[lane]++;
+                cash_[s] += house_cost * HOTEL / 2;
+            }
+        } else {
+            break;
+        }
+        changed = true;
+    }
+    if (changed) {
+        this->refresh_rents(lane);
+    }
+    return cash_[s] >= amount;
+}
+
+// Cash and property go to the creditor, or back to the bank, and held jail cards to their decks
+void LockstepSim::bankrupt(uint32_t lane, uint32_t seat, int32_t creditor) {
+    const size_t s = at(seat, lane);
+    retired_[s] = -1;
+    alive_[lane]--;
+    if (creditor >= 0) {
+        cash_[at(creditor, lane)] += cash_[s];
+        owned_[at(creditor, lane)] |= owned_[s];
+    }
+    for (uint32_t bits = owned_[s]; bits; bits &= bits - 1) {
+        const size_t p = at(std::countr_zero(bits), lane);
+        owner_[p] = creditor;
+        if (creditor < 0) {
+            mortgaged_[p] = 0;
+        }
+    }
+    cash_[s] = 0;
+    owned_[s] = 0;
+    jail_cards_out_[lane] &= ~jail_cards_[s];
+    jail_cards_[s] = 0;
+    jail_[s] = FREE;
+    doubles_[s] = 0;
+    this->refresh_rents(lane);
+}
+
+void LockstepSim::buy(uint32_t lane, uint32_t seat, uint32_t index) {
+    const size_t s = at(seat, lane);
+    cash_[s] -= board_.ownables[index].purchase_price;
+    owned_[s] |= 1u << index;
+    owner_[at(index, lane)] = static_cast<int32_t>(seat);
+    this->refresh_rents(lane);
+}
+
+// Build evenly across monopolies while keeping $150, like the MCTS rollout policy
+void LockstepSim::develop(uint32_t lane, uint32_t seat) {
+    const size_t s = at(seat, lane);
+    bool built = false;
+    for (bool again = monopolies_[s] != 0; again;) {
+        again = false;
+        for (uint32_t colours = monopolies_[s]; colours; colours &= colours - 1) {
+            const uint32_t mask = board_.colourMask(static_cast<Colour>(std::countr_zero(colours)));
+            uint32_t lowest = std::countr_zero(mask);
+            for (uint32_t group = mask; group; group &= group - 1) {
+                const uint32_t index = std::countr_zero(group);
+                if (houses_[at(index, lane)] < houses_[at(lowest, lane)]) {
+                    lowest = index;
+                }
+            }
+            const size_t p = at(lowest, lane);
+            const int32_t house_cost = board_.ownables[lowest].house_cost;
+            if (houses_[p] >= HOTEL || cash_[s] < house_cost + 150) {
+                continue;
+            }
+            if (houses_[p] < 4) {
+                if (houses_left_[lane] == 0) {
+                    continue;
+                }
+                houses_left_[lane]--;
+            } else {
+                if (hotels_left_[lane] == 0) {
+                    continue;
+                }
+                hotels_left_[lane]--;
+                houses_left_[lane] += 4;
+            }
+            houses_[p]++;
+            cash_[s] -= house_cost;
+            built = again = true;
+        }
+    }
+    if (built) {
+        this->refresh_rents(lane);
+    }
+}
+
+// Rent of every property and each seat's monopolies, after anything that changes them
+void LockstepSim::refresh_rents(uint32_t lane) {
+    std::array<int32_t, GameState::MAX_PLAYERS> railroads{};
+    std::array<int32_t, GameState::MAX_PLAYERS> utilities{};
+    for (uint32_t seat = 0; seat < num_seats_; seat++) {
+        monopolies_[at(seat, lane)] = 0;
+    }
+    for (uint32_t index = 0; index < NUM_PROPERTIES; index++) {
+        const size_t p = at(index, lane);
+        if (owner_[p] < 0 || mortgaged_[p]) {
+            continue;
+        }
+        const TileType type = board_.ownables[index].type;
+        railroads[owner_[p]] += type == TileType::Railroad;
+        utilities[owner_[p]] += type == TileType::Utility;
+    }
+    for (uint32_t colour = 1; colour < board_.colour_masks.size(); colour++) {
+        const uint32_t mask = board_.colour_masks[colour];
+        const int32_t owner = owner_[at(std::countr_zero(mask), lane)];
+        bool whole = owner >= 0;
+        for (uint32_t group = mask; group && whole; group &= group - 1) {
+            const size_t p = at(std::countr_zero(group), lane);
+            whole = owner_[p] == owner && !mortgaged_[p];
+        }
+        if (whole) {
+            monopolies_[at(owner, lane)] |= 1u << colour;
+        }
+    }
+
+    for (uint32_t index = 0; index < NUM_PROPERTIES; index++) {
+        const size_t p = at(index, lane);
+        const int32_t owner = owner_[p];
+        if (owner < 0 || mortgaged_[p]) {
+            rent_[p] = 0;
+            continue;
+        }
+        const OwnableInfo& info = board_.ownables[index];
+        switch (info.type) {
+        case TileType::Railroad:
+            rent_[p] = board_.railroads[0].rent[railroads[owner] - 1];
+            break;
+        case TileType::Utility:
+            rent_[p] = board_.utilities[0].multiplier[utilities[owner] - 1];
+            break;
+        default: {
+            const bool monopoly = monopolies_[at(owner, lane)] >> static_cast<uint32_t>(info.colour) & 1;
+            const int32_t houses = houses_[p];
+            rent_[p] = houses ? tables_.street_rent[index][houses] : tables_.street_rent[index][0] * (monopoly ? 2 : 1);
+        }
+        }
+    }
+}
+}
+
+bool parse_lockstep_policy(std::string_view name, LockstepPolicy& policy) {
+    if (name == "random") {
+        policy = LockstepPolicy::RANDOM;
+    } else if (name == "greedy") {
+        policy = LockstepPolicy::GREEDY;
+    } else if (name == "heuristic") {
+        policy = LockstepPolicy::HEURISTIC;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* lockstep_policy_name(LockstepPolicy policy) {
+    switch (policy) {
+    case LockstepPolicy::RANDOM:
+        return "random";
+    case LockstepPolicy::GREEDY:
+        return "greedy";
+    case LockstepPolicy::HEURISTIC:
+        return "heuristic";
+    }
+    return "unknown";
+}
+
+bool lockstep_simd_available() {
+#if LOCKSTEP_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+LockstepStats run_lockstep(const LockstepConfig& config) {
+    if (config.seats.size() < 2 || config.seats.size() > GameState::MAX_PLAYERS) {
+        throw std::runtime_error("Lockstep games need 2 to " + std::to_string(GameState::MAX_PLAYERS) + " seats");
+    }
+    if (config.max_turns == 0) {
+        throw std::runtime_error("Lockstep max_turns must be positive");
+    }
+
+    unsigned int threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned int>(std::clamp<uint64_t>(config.games, 1, threads));
+    const bool simd = config.simd && lockstep_simd_available();
+
+    // Contiguous game ranges per thread, no more lanes than a range can fill
+    std::vector<LockstepStats> parts(threads);
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int t = 0; t < threads; t++) {
+        const uint64_t first = config.games * t / threads;
+        const uint64_t end = config.games * (t + 1) / threads;
+        const uint64_t wanted = std::clamp<uint64_t>(std::min<uint64_t>(config.lanes, end - first), 1, UINT32_MAX - WIDTH);
+        const uint32_t lanes = static_cast<uint32_t>((wanted + WIDTH - 1) / WIDTH * WIDTH);
+        workers.emplace_back([&config, &parts, t, first, end, lanes, simd] {
+            LockstepSim sim(config, first, end, lanes, simd);
+            sim.run(parts[t]);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    LockstepStats stats;
+    for (const LockstepStats& part : parts) {
+        stats.games += part.games;
+        stats.rounds += part.rounds;
+        stats.player_turns += part.player_turns;
+        for (size_t seat = 0; seat < stats.wins.size(); seat++) {
+            stats.wins[seat] += part.wins[seat];
+        }
+        stats.draws += part.draws;
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.simd = simd;
+    return stats;
+}
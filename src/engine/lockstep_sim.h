@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "game_state.h"
+
+// Built-in seat policies of the lockstep simulator, no agent plugins involved
+enum class LockstepPolicy : uint8_t {
+    RANDOM,    // buys half the time it can afford to, waits out jail
+    GREEDY,    // buys keeping $100, leaves jail at once with a card or the fine
+    HEURISTIC, // the MCTS rollout policy: buys and builds evenly keeping $150, waits out jail
+};
+
+bool parse_lockstep_policy(std::string_view name, LockstepPolicy& policy);
+const char* lockstep_policy_name(LockstepPolicy policy);
+
+struct LockstepConfig {
+    uint64_t seed = 0;
+    uint64_t games = 0;
+    uint32_t max_turns = 1000; // rounds, like GameState::turn
+    std::vector<LockstepPolicy> seats; // 2 to MAX_PLAYERS
+    uint32_t lanes = 64; // games in flight per thread, rounded up to a multiple of 8
+    unsigned int threads = 1; // 0 = one per hardware thread
+    bool simd = true; // AVX2 kernel if the CPU has it
+};
+
+struct LockstepStats {
+    uint64_t games = 0;
+    uint64_t rounds = 0; // summed over games
+    uint64_t player_turns = 0;
+    std::array<uint64_t, GameState::MAX_PLAYERS> wins{};
+    uint64_t draws = 0; // out of rounds, or nobody left
+    double seconds = 0;
+    bool simd = false; // the AVX2 kernel ran
+};
+
+// Plays games between built-in policies many at a time: each thread keeps config.lanes games in
+// structure-of-arrays lanes and advances them one seat at a time, 8 lanes per AVX2 vector. Dice,
+// movement, passing Go, taxes, going to jail and paying rent run on whole vectors; buying, cards,
+// jail, raising funds and building drop to scalar code for the lanes that need them. Finished lanes
+// are refilled with the next game.
+//
+// A simplified rules model for rollout estimates and win-rate tables, not a replay of Engine: no
+// auctions or trades, cards are drawn uniformly with replacement, funds are raised by mortgaging the
+// cheapest property first and then selling houses, a bankrupt player's property goes to the creditor
+// or back to the bank. Game g only draws from derive_seed(seed, g), so the stats are the same for
+// any lanes, threads or kernel. Throws std::runtime_error on a bad config.
+LockstepStats run_lockstep(const LockstepConfig& config);
+
+bool lockstep_simd_available();
@@ -0,0 +1,95 @@
+#include "log.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+constexpr size_t FLUSH_BYTES = 4096;
+
+LogLevel initial_level() {
+    LogLevel level = LogLevel::INFO;
+    const char* name = std::getenv("MONOPOLY_LOG");
+    if (name && !parse_log_level(name, level)) {
+        std::fprintf(stderr, "Unknown MONOPOLY_LOG level \"%s\", using info\n", name);
+    }
+    return level;
+}
+
+std::atomic<LogLevel>& runtime_level() {
+    static std::atomic<LogLevel> level{initial_level()};
+    return level;
+}
+
+const char* level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::TRACE: return "trace";
+    case LogLevel::DEBUG: return "debug";
+    case LogLevel::INFO: return "info";
+    case LogLevel::WARN: return "warn";
+    case LogLevel::ERROR: return "error";
+    case LogLevel::OFF: return "off";
+    }
+    return "unknown";
+}
+
+// Lines of one thread, written out whole so threads never interleave within a line
+struct Sink {
+    std::ostringstream line;
+    std::string pending;
+
+    void flush() {
+        if (!pending.empty()) {
+            std::fwrite(pending.data(), 1, pending.size(), stderr);
+            pending.clear();
+        }
+    }
+    ~Sink() {
+        this->flush();
+    }
+};
+
+Sink& sink() {
+    thread_local Sink sink;
+    return sink;
+}
+}
+
+bool parse_log_level(std::string_view name, LogLevel& level) {
+    for (LogLevel candidate : {LogLevel::TRACE, LogLevel::DEBUG, LogLevel::INFO, LogLevel::WARN, LogLevel::ERROR, LogLevel::OFF}) {
+        if (name == level_name(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+LogLevel log_level() {
+    return runtime_level().load(std::memory_order_relaxed);
+}
+
+void set_log_level(LogLevel level) {
+    runtime_level().store(level, std::memory_order_relaxed);
+}
+
+void log_flush() {
+    sink().flush();
+}
+
+std::ostringstream& log_detail::begin_line(LogLevel level) {
+    std::ostringstream& line = sink().line;
+    line.str(std::string());
+    line << '[' << level_name(level) << "] ";
+    return line;
+}
+
+// Warnings and errors go out at once, with anything buffered before them
+void log_detail::end_line(LogLevel level) {
+    Sink& s = sink();
+    s.line << '\n';
+    s.pending += s.line.view();
+    if (level >= LogLevel::WARN || s.pending.size() >= FLUSH_BYTES) {
+        s.flush();
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <sstream>
+#include <string_view>
+
+// Leveled diagnostics on stderr. Levels below MONOPOLY_LOG_LEVEL are compiled out, arguments and
+// all; the rest are checked against the runtime level (MONOPOLY_LOG in the environment, default
+// info) and collected in a per-thread buffer that goes out a line block at a time.
+enum class LogLevel : uint8_t {
+    TRACE,
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF,
+};
+
+// Lowest level compiled in, as a LogLevel number
+#ifndef MONOPOLY_LOG_LEVEL
+#ifdef NDEBUG
+#define MONOPOLY_LOG_LEVEL 2
+#else
+#define MONOPOLY_LOG_LEVEL 1
+#endif
+#endif
+
+bool parse_log_level(std::string_view name, LogLevel& level);
+LogLevel log_level();
+void set_log_level(LogLevel level);
+
+// Sends this thread's buffered lines to stderr
+void log_flush();
+
+namespace log_detail {
+inline bool enabled(LogLevel level) {
+    return level >= log_level();
+}
+
+std::ostringstream& begin_line(LogLevel level);
+void end_line(LogLevel level);
+
+template <class... Args>
+void write(LogLevel level, const Args&... args) {
+    std::ostringstream& line = begin_line(level);
+    (line << ... << args);
+    end_line(level);
+}
+}
+
+// LOG(DEBUG, "Engine init, ", n, " agents")
+#define LOG(level, ...)                                                                      \
+    do {                                                                                     \
+        if constexpr (static_cast<int>(LogLevel::level) >= MONOPOLY_LOG_LEVEL) {             \
+            if (log_detail::enabled(LogLevel::level)) {                                      \
+                log_detail::write(LogLevel::level, __VA_ARGS__);                             \
+            }                                                                                \
+        }                                                                                    \
+    } while (0)
@@ -0,0 +1,129 @@
+#include "manifest.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+const JsonValue& require(const JsonValue& object, const char* key) {
+    const JsonValue* value = object.find(key);
+    if (!value) {
+        throw std::runtime_error(std::string("Manifest entry missing \"") + key + "\"");
+    }
+    return *value;
+}
+}
+
+GameConfig ManifestParser::parse(std::string_view line) {
+    return this->parse(parse_json(line));
+}
+
+GameConfig ManifestParser::parse(const JsonValue& entry) {
+    if (!entry.is_object()) {
+        throw std::runtime_error("Manifest entry must be a JSON object");
+    }
+
+    GameConfig config = {};
+    config.game_id = require(entry, "game_id").as_u64("game_id");
+    config.seed = require(entry, "seed").as_u64("seed");
+    config.max_turns = static_cast<uint32_t>(require(entry, "max_turns").as_u64("max_turns"));
+
+    const JsonValue* reshuffle_decks = entry.find("reshuffle_decks");
+    if (reshuffle_decks) {
+        if (reshuffle_decks->type != JsonValue::Type::Bool) {
+            throw std::runtime_error("\"reshuffle_decks\" must be true or false");
+        }
+        config.reshuffle_decks = reshuffle_decks->boolean;
+    }
+
+    const JsonValue* rng = entry.find("rng");
+    if (rng) {
+        if (!rng->is_string() || !parse_rng_backend(rng->text, config.rng)) {
+            throw std::runtime_error("\"rng\" must be \"mt19937\" or \"xoshiro256\"");
+        }
+    }
+
+    const JsonValue* auction = entry.find("auction");
+    if (auction) {
+        if (!auction->is_string() || !parse_auction_mode(auction->text, config.auction_mode)) {
+            throw std::runtime_error("\"auction\" must be \"rounds\" or \"proxy\"");
+        }
+    }
+    const JsonValue* auction_increment = entry.find("auction_increment");
+    if (auction_increment) {
+        config.auction_increment = static_cast<uint32_t>(auction_increment->as_u64("auction_increment"));
+        if (config.auction_increment == 0) {
+            throw std::runtime_error("\"auction_increment\" must be at least 1");
+        }
+    }
+
+    const JsonValue* log_path = entry.find("log_path");
+    if (log_path) {
+        if (!log_path->is_string()) {
+            throw std::runtime_error("\"log_path\" must be a string");
+        }
+        config.log_path = log_path->text;
+    }
+
+    const JsonValue* stats = entry.find("stats");
+    if (stats) {
+        if (stats->type != JsonValue::Type::Bool) {
+            throw std::runtime_error("\"stats\" must be true or false");
+        }
+        config.collect_stats = stats->boolean;
+    }
+
+    const JsonValue* call_budget = entry.find("call_budget_ms");
+    if (call_budget) {
+        config.budget.call_ms = static_cast<uint32_t>(call_budget->as_u64("call_budget_ms"));
+    }
+    const JsonValue* game_budget = entry.find("game_budget_ms");
+    if (game_budget) {
+        config.budget.game_ms = static_cast<uint32_t>(game_budget->as_u64("game_budget_ms"));
+    }
+
+    const JsonValue& agents = require(entry, "agents");
+    if (!agents.is_array() || agents.items.empty()) {
+        throw std::runtime_error("Manifest entry needs at least one agent");
+    }
+
+    for (const auto& agent : agents.items) {
+        const JsonValue& path = require(agent, "path");
+        if (!path.is_string()) {
+            throw std::runtime_error("Agent \"path\" must be a string");
+        }
+
+        AgentSpec spec;
+        spec.path = path.text;
+
+        const JsonValue* name = agent.find("name");
+        spec.name = (name && name->is_string()) ? name->text : path.text;
+
+        const JsonValue* inline_config = agent.find("config");
+        const JsonValue* config_path = agent.find("config_file");
+        if (inline_config) {
+            // Strings are passed through as-is, objects keep their raw JSON text
+            spec.config_json = inline_config->text;
+        } else if (config_path && config_path->is_string()) {
+            spec.config_json = this->config_file(config_path->text);
+        } else {
+            spec.config_json = "{}";
+        }
+        config.agent_specs.push_back(std::move(spec));
+    }
+    return config;
+}
+
+const std::string& ManifestParser::config_file(const std::string& path) {
+    auto it = this->config_files_.find(path);
+    if (it != this->config_files_.end()) {
+        return it->second;
+    }
+
+    std::ifstream f(path);
+    if (!f) {
+        throw std::runtime_error("Failed to open config file: " + path);
+    }
+    std::stringstream buffer;
+    buffer << f.rdbuf();
+    return this->config_files_.emplace(path, buffer.str()).first->second;
+}
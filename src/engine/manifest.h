@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "engine.h"
+#include "json_reader.h"
+
+// Parses one game request per manifest line, same shape neat_training.py builds:
+// {"game_id":1,"seed":42,"max_turns":1500,"agents":[{"path":"...","config":{...},"name":"..."}]}
+// An agent takes either an inline "config" (object or string) or a "config_file" path.
+class ManifestParser {
+public:
+    // Throws std::runtime_error on malformed entries
+    GameConfig parse(std::string_view line);
+    GameConfig parse(const JsonValue& entry);
+
+private:
+    // Config files are read once per batch, most games share the same few files
+    const std::string& config_file(const std::string& path);
+    std::unordered_map<std::string, std::string> config_files_;
+};
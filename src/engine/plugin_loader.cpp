@@ -1,5 +1,7 @@
 #include "plugin_loader.h"
 #include <stdexcept>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -55,21 +57,42 @@ public:
 
     // Get agent + vtable
     AgentExport get_export() override {
+        std::lock_guard<std::mutex> lock(mutex_);
         return cached_;
     }
 
     // Run factory function, resulting agent object stored in cached_
+    // Handles are shared across engine threads, so cached_ is only touched under the lock
     AgentExport make(const std::string& cfg) override {
-        cached_ = factory_(cfg.c_str());
-        if (!cached_.vtable.abi_version || cached_.vtable.abi_version() != ABI_VERSION) {
+        AgentExport made = factory_(cfg.c_str());
+        if (!made.vtable.abi_version || made.vtable.abi_version() != ABI_VERSION) {
             throw std::runtime_error("ABI version mismatch");
         }
-        return cached_;
+        std::lock_guard<std::mutex> lock(mutex_);
+        cached_ = made;
+        return made;
     }
+
+private:
+    std::mutex mutex_;
 };
 
-// Function that instantiates the class w/ path
-// unique_ptr for automatic memory management
-std::unique_ptr<PluginHandle> LoadAgentLibrary(const std::string& path) {
-    return std::unique_ptr<PluginHandle>(new PluginHandleImpl(path));
-}
\ No newline at end of file
+// Function that instantiates the class w/ path, or returns the already loaded one
+// shared_ptr since every adapter of the same library shares the handle
+std::shared_ptr<PluginHandle> LoadAgentLibrary(const std::string& path) {
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, std::shared_ptr<PluginHandle>> cache;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(path);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    auto handle = std::shared_ptr<PluginHandle>(new PluginHandleImpl(path));
+    cache.emplace(path, handle);
+    return handle;
+}
+std::recursive_mutex& SerialPluginMutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <mutex>
 #include "agent_abi.h"
 
 // Abstract class
@@ -11,4 +12,9 @@ public:
     virtual AgentExport make(const std::string& cfg) = 0;
 };
 
-std::unique_ptr<PluginHandle> LoadAgentLibrary(const std::string& path);
\ No newline at end of file
+// Loaded libraries are cached by path and stay loaded for the lifetime of the process,
+// so batch runs only pay for dlopen once per agent library
+std::shared_ptr<PluginHandle> LoadAgentLibrary(const std::string& path);
+
+// Held around any use of a plugin that declares neither AGENT_FLAG_THREAD_SAFE nor AGENT_FLAG_THREAD_CONFINED
+std::recursive_mutex& SerialPluginMutex();
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include "engine.h"
+#include "replay_log.h"
+#include "result_json.h"
+
+// Re-executes recorded games from their replay logs, without loading any agent.
+// One JSON line per log; "match" is false when the replay ends somewhere else than the
+// recorded game did, e.g. after an engine change that alters the rules.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage:\n  " << argv[0] << " <replay_log> [<replay_log> ...]\n";
+        return EXIT_FAILURE;
+    }
+
+    int failures = 0;
+    uint64_t total_turns = 0;
+    double seconds = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string path = argv[i];
+        try {
+            ReplayReader reader = ReplayReader::open(path);
+            ReplayPolicy policy(reader);
+
+            auto start = std::chrono::steady_clock::now();
+            Engine engine(reader.initial_state(), policy, &reader);
+            while (!engine.game_over()) {
+                engine.play_turn();
+            }
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const GameState& state = engine.state();
+            const int winner = state.turn < state.max_turns ? engine.winner() : -1;
+            const ReplayEnd recorded = reader.end();
+            const bool match = recorded.turns == state.turn && recorded.winner == winner && recorded.digest == state_digest(state);
+            total_turns += state.turn;
+            failures += match ? 0 : 1;
+
+            std::cout << "{\"log\":" << json_escape(path)
+                      << ",\"game_id\":" << reader.header().game_id
+                      << ",\"turns\":" << state.turn
+                      << ",\"winner\":" << winner
+                      << ",\"match\":" << (match ? "true" : "false") << "}\n";
+        } catch (const std::exception& e) {
+            failures++;
+            std::cout << "{\"log\":" << json_escape(path) << ",\"error\":" << json_escape(e.what()) << "}\n";
+        }
+    }
+
+    std::cerr << argc - 1 << " games, " << total_turns << " turns replayed in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << static_cast<uint64_t>(total_turns / seconds) << " turns/s)";
+    }
+    std::cerr << "\n";
+    return failures == 0 ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,319 @@
+#include "replay_log.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+constexpr char REPLAY_MAGIC[4] = {'M', 'R', 'E', 'P'};
+constexpr uint32_t REPLAY_VERSION = 2;
+
+// FNV-1a
+void mix(uint64_t& hash, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= 0x100000001b3ULL;
+    }
+}
+}
+
+uint64_t state_digest(const GameState& state) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    mix(hash, state.turn);
+    mix(hash, state.houses_remaining);
+    mix(hash, state.hotels_remaining);
+    for (const PlayerView& player : state.seated_players()) {
+        mix(hash, player.cash);
+        mix(hash, player.position);
+        mix(hash, player.retired);
+        mix(hash, player.in_jail);
+        mix(hash, player.jail_free_cards);
+    }
+    for (uint32_t index = 0; index < GameState::NUM_PROPERTIES; index++) {
+        mix(hash, state.owner_of(index));
+        mix(hash, state.is_mortgaged(index));
+        mix(hash, state.houses[index]);
+        mix(hash, state.has_hotel(index));
+    }
+    for (double penalty : state.penalties) {
+        mix(hash, static_cast<uint64_t>(penalty * 2));
+    }
+    return hash;
+}
+
+ReplayWriter::ReplayWriter(const ReplayHeader& header) : bytes_(std::begin(REPLAY_MAGIC), std::end(REPLAY_MAGIC)) {
+    this->put_u32(REPLAY_VERSION);
+    this->put_u64(header.game_id);
+    this->put_u64(header.seed);
+    this->put_u32(header.max_turns);
+    this->put_u8(static_cast<uint8_t>(header.num_players));
+    this->put_u8(static_cast<uint8_t>(header.rng));
+    this->put_u8(header.reshuffle_decks);
+    this->put_u8(static_cast<uint8_t>(header.auction_mode));
+    bytes_.insert(bytes_.end(), header.community_deck.begin(), header.community_deck.end());
+    bytes_.insert(bytes_.end(), header.chance_deck.begin(), header.chance_deck.end());
+    for (uint32_t i = 0; i < header.num_players; i++) {
+        const std::string name = i < header.agent_names.size() ? header.agent_names[i] : std::string();
+        this->put_u16(static_cast<uint16_t>(name.size()));
+        bytes_.insert(bytes_.end(), name.begin(), name.end());
+    }
+    this->put_u32(header.auction_increment);
+}
+
+void ReplayWriter::put_u16(uint16_t value) {
+    this->put_u8(static_cast<uint8_t>(value));
+    this->put_u8(static_cast<uint8_t>(value >> 8));
+}
+
+void ReplayWriter::put_u32(uint32_t value) {
+    this->put_u16(static_cast<uint16_t>(value));
+    this->put_u16(static_cast<uint16_t>(value >> 16));
+}
+
+void ReplayWriter::put_u64(uint64_t value) {
+    this->put_u32(static_cast<uint32_t>(value));
+    this->put_u32(static_cast<uint32_t>(value >> 32));
+}
+
+void ReplayWriter::roll(uint32_t outcome) {
+    this->put_u8(static_cast<uint8_t>(ReplayTag::ROLL));
+    this->put_u8(static_cast<uint8_t>(outcome));
+}
+
+void ReplayWriter::shuffle(uint8_t deck_id, const CardDeck& deck) {
+    this->put_u8(static_cast<uint8_t>(ReplayTag::SHUFFLE));
+    this->put_u8(deck_id);
+    this->put_u8(static_cast<uint8_t>(deck.count));
+    for (uint32_t i = 0; i < deck.count; i++) {
+        this->put_u8(static_cast<uint8_t>(deck.cards[(deck.head + i) % CardDeck::CAPACITY]));
+    }
+}
+
+void ReplayWriter::decision(ReplayTag tag, const Action& action) {
+    this->put_u8(static_cast<uint8_t>(tag));
+    this->put_u8(static_cast<uint8_t>(action.type));
+    switch (action.type) {
+    case ACTION_LANDED_PROPERTY:
+        this->put_u8(action.buying_property);
+        break;
+    case ACTION_TRADE: {
+        const TradeOffer& offer = action.trade_offer;
+        this->put_u32(offer.player_to_offer);
+        for (const TradeDetail* detail : {&offer.offer_from, &offer.offer_to}) {
+            this->put_u32(detail->cash);
+            this->put_u32(detail->jail_cards);
+            const uint8_t property_num = detail->properties ? detail->property_num : 0;
+            this->put_u8(property_num);
+            for (uint8_t i = 0; i < property_num; i++) {
+                this->put_u32(detail->properties[i]);
+            }
+        }
+        break;
+    }
+    case ACTION_TRADE_RESPONSE:
+        this->put_u8(action.trade_response);
+        break;
+    case ACTION_MORTGAGE:
+    case ACTION_UNMORTGAGE:
+    case ACTION_DEVELOP:
+    case ACTION_UNDEVELOP:
+        this->put_u32(action.property_position);
+        break;
+    case ACTION_AUCTION_BID:
+        this->put_u32(action.auction_bid);
+        break;
+    default:
+        break;
+    }
+}
+
+void ReplayWriter::overrun() {
+    this->put_u8(static_cast<uint8_t>(ReplayTag::OVERRUN));
+}
+
+void ReplayWriter::end(const ReplayEnd& end) {
+    this->put_u8(static_cast<uint8_t>(ReplayTag::END));
+    this->put_u64(end.turns);
+    this->put_u32(static_cast<uint32_t>(end.winner));
+    this->put_u64(end.digest);
+}
+
+void ReplayWriter::save(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(bytes_.data()), static_cast<std::streamsize>(bytes_.size()));
+    if (!f) {
+        throw std::runtime_error("Failed to write replay log: " + path);
+    }
+}
+
+ReplayReader::ReplayReader(std::vector<uint8_t> bytes) : bytes_(std::move(bytes)) {
+    const uint8_t* magic = this->take(4);
+    if (!std::equal(magic, magic + 4, std::begin(REPLAY_MAGIC))) {
+        throw std::runtime_error("Not a replay log");
+    }
+    const uint32_t version = this->get_u32();
+    if (version != REPLAY_VERSION && version != 1) {
+        throw std::runtime_error("Unsupported replay log version");
+    }
+    header_.game_id = this->get_u64();
+    header_.seed = this->get_u64();
+    header_.max_turns = this->get_u32();
+    header_.num_players = this->get_u8();
+    header_.rng = static_cast<RngBackend>(this->get_u8());
+    header_.reshuffle_decks = this->get_u8() != 0;
+    const uint8_t auction_mode = this->get_u8(); // pad in version 1
+    header_.auction_mode = version == 1 ? AuctionMode::ROUNDS : static_cast<AuctionMode>(auction_mode);
+    const uint8_t* community = this->take(CardDeck::CAPACITY);
+    std::copy(community, community + CardDeck::CAPACITY, header_.community_deck.begin());
+    const uint8_t* chance = this->take(CardDeck::CAPACITY);
+    std::copy(chance, chance + CardDeck::CAPACITY, header_.chance_deck.begin());
+    for (uint32_t i = 0; i < header_.num_players; i++) {
+        const uint16_t length = this->get_u16();
+        const uint8_t* name = this->take(length);
+        header_.agent_names.emplace_back(name, name + length);
+    }
+    header_.auction_increment = version == 1 ? 0 : this->get_u32();
+}
+
+ReplayReader ReplayReader::open(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        throw std::runtime_error("Failed to open replay log: " + path);
+    }
+    return ReplayReader(std::vector<uint8_t>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()));
+}
+
+GameState ReplayReader::initial_state() const {
+    GameState state = GameState::initial(header_.seed, header_.num_players, header_.max_turns, header_.reshuffle_decks, header_.rng);
+    std::copy(header_.community_deck.begin(), header_.community_deck.end(), state.community_deck.cards.begin());
+    std::copy(header_.chance_deck.begin(), header_.chance_deck.end(), state.chance_deck.cards.begin());
+    state.auction_mode = header_.auction_mode;
+    state.auction_increment = header_.auction_increment;
+    return state;
+}
+
+const uint8_t* ReplayReader::take(size_t n) {
+    if (bytes_.size() - offset_ < n) {
+        throw std::runtime_error("Replay log truncated");
+    }
+    const uint8_t* data = bytes_.data() + offset_;
+    offset_ += n;
+    return data;
+}
+
+uint16_t ReplayReader::get_u16() {
+    const uint8_t* data = this->take(2);
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t ReplayReader::get_u32() {
+    const uint32_t low = this->get_u16();
+    return low | (static_cast<uint32_t>(this->get_u16()) << 16);
+}
+
+uint64_t ReplayReader::get_u64() {
+    const uint64_t low = this->get_u32();
+    return low | (static_cast<uint64_t>(this->get_u32()) << 32);
+}
+
+void ReplayReader::expect(ReplayTag tag) {
+    const size_t at = offset_;
+    const uint8_t found = this->get_u8();
+    if (found != static_cast<uint8_t>(tag)) {
+        throw std::runtime_error("Replay diverged at byte " + std::to_string(at) + ": expected event " +
+                                 std::to_string(static_cast<int>(tag)) + ", log has " + std::to_string(found));
+    }
+}
+
+uint32_t ReplayReader::roll() {
+    this->expect(ReplayTag::ROLL);
+    const uint32_t outcome = this->get_u8();
+    if (outcome >= 36) {
+        throw std::runtime_error("Replay log has an invalid dice outcome");
+    }
+    return outcome;
+}
+
+void ReplayReader::shuffle(uint8_t deck_id, CardDeck& deck) {
+    this->expect(ReplayTag::SHUFFLE);
+    const uint8_t logged_deck = this->get_u8();
+    const uint8_t count = this->get_u8();
+    if (logged_deck != deck_id || count != deck.count) {
+        throw std::runtime_error("Replay diverged: reshuffled a different deck");
+    }
+    const uint8_t* cards = this->take(count);
+    std::copy(cards, cards + count, deck.cards.begin());
+    deck.head = 0;
+    deck.undrawn = count;
+}
+
+Action ReplayReader::decision(ReplayTag tag, std::vector<uint32_t> (&storage)[2]) {
+    this->expect(tag);
+    Action action = {};
+    action.type = static_cast<ActionType>(this->get_u8());
+    switch (action.type) {
+    case ACTION_LANDED_PROPERTY:
+        action.buying_property = this->get_u8() != 0;
+        break;
+    case ACTION_TRADE: {
+        TradeOffer& offer = action.trade_offer;
+        offer.player_to_offer = this->get_u32();
+        TradeDetail* details[2] = {&offer.offer_from, &offer.offer_to};
+        for (int d = 0; d < 2; d++) {
+            details[d]->cash = this->get_u32();
+            details[d]->jail_cards = this->get_u32();
+            details[d]->property_num = this->get_u8();
+            storage[d].resize(details[d]->property_num);
+            for (uint32_t& position : storage[d]) {
+                position = this->get_u32();
+            }
+            details[d]->properties = storage[d].data();
+        }
+        break;
+    }
+    case ACTION_TRADE_RESPONSE:
+        action.trade_response = this->get_u8() != 0;
+        break;
+    case ACTION_MORTGAGE:
+    case ACTION_UNMORTGAGE:
+    case ACTION_DEVELOP:
+    case ACTION_UNDEVELOP:
+        action.property_position = this->get_u32();
+        break;
+    case ACTION_AUCTION_BID:
+        action.auction_bid = this->get_u32();
+        break;
+    default:
+        break;
+    }
+    return action;
+}
+
+bool ReplayReader::overrun() {
+    if (offset_ >= bytes_.size() || bytes_[offset_] != static_cast<uint8_t>(ReplayTag::OVERRUN)) {
+        return false;
+    }
+    offset_++;
+    return true;
+}
+
+ReplayEnd ReplayReader::end() {
+    this->expect(ReplayTag::END);
+    ReplayEnd end;
+    end.turns = this->get_u64();
+    end.winner = static_cast<int>(this->get_u32());
+    end.digest = this->get_u64();
+    return end;
+}
+
+Action ReplayPolicy::agent_turn(const GameState&, uint32_t) {
+    return reader_.decision(ReplayTag::TURN, storage_);
+}
+
+Action ReplayPolicy::auction(const GameState&, uint32_t, const AuctionView&) {
+    return reader_.decision(ReplayTag::AUCTION, storage_);
+}
+
+Action ReplayPolicy::trade_offer(const GameState&, uint32_t, const TradeOffer&) {
+    return reader_.decision(ReplayTag::TRADE, storage_);
+}
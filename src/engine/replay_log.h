@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "engine.h"
+
+// Binary replay log of one game, little-endian:
+//   header: magic 'MREP', u32 version, u64 game_id, u64 seed, u32 max_turns, u8 num_players,
+//           u8 rng backend, u8 reshuffle_decks, u8 auction mode, 16 u8 community deck, 16 u8 chance deck,
+//           per player: u16 name length, name bytes, then u32 auction increment
+//           (version 1 logs have a pad byte for the mode and no increment: rounds auctions)
+//   events, each a u8 tag:
+//     ROLL     u8 dice outcome, (roll_1 - 1) * 6 + (roll_2 - 1)
+//     SHUFFLE  u8 deck (0 community, 1 chance), u8 count, count u8 cards from the top
+//     TURN / AUCTION / TRADE  one decision of that kind, as an encoded Action
+//     OVERRUN  no payload, follows a decision the agent ran out of time on (it was penalized)
+//     END      u64 turns, i32 winner, u64 state digest
+// Actions are a u8 ActionType then only the field that type uses: u8 for bools, u32 for
+// positions and bids, and for trades u32 player_to_offer plus two details of
+// u32 cash, u32 jail_cards, u8 property_num, property_num u32 positions.
+// Every random outcome is in the log, so replaying needs neither the agents nor the rng.
+enum class ReplayTag : uint8_t {
+    ROLL = 1,
+    SHUFFLE,
+    TURN,
+    AUCTION,
+    TRADE,
+    END,
+    OVERRUN,
+};
+
+struct ReplayHeader {
+    uint64_t game_id;
+    uint64_t seed;
+    uint32_t max_turns;
+    uint32_t num_players;
+    RngBackend rng;
+    bool reshuffle_decks;
+    AuctionMode auction_mode;
+    uint32_t auction_increment;
+    std::array<uint8_t, CardDeck::CAPACITY> community_deck;
+    std::array<uint8_t, CardDeck::CAPACITY> chance_deck;
+    std::vector<std::string> agent_names;
+};
+
+struct ReplayEnd {
+    uint64_t turns;
+    int winner;
+    uint64_t digest;
+};
+
+// Hash of the parts of a position results depend on, to check a replay ended where the game did
+uint64_t state_digest(const GameState& state);
+
+class ReplayWriter {
+public:
+    explicit ReplayWriter(const ReplayHeader& header);
+
+    void roll(uint32_t outcome);
+    void shuffle(uint8_t deck_id, const CardDeck& deck);
+    void decision(ReplayTag tag, const Action& action);
+    void overrun();
+    void end(const ReplayEnd& end);
+
+    // Throws std::runtime_error if the file cannot be written
+    void save(const std::string& path) const;
+
+private:
+    void put_u8(uint8_t value) { bytes_.push_back(value); };
+    void put_u16(uint16_t value);
+    void put_u32(uint32_t value);
+    void put_u64(uint64_t value);
+
+    std::vector<uint8_t> bytes_;
+};
+
+// Reads a log back in order. Every read throws std::runtime_error if the next event is not
+// the expected one, i.e. the engine asked for something the recorded game did not.
+class ReplayReader {
+public:
+    explicit ReplayReader(std::vector<uint8_t> bytes);
+    static ReplayReader open(const std::string& path);
+
+    const ReplayHeader& header() const { return header_; };
+    // Fresh game with the recorded seed, settings and deck order
+    GameState initial_state() const;
+
+    uint32_t roll();
+    void shuffle(uint8_t deck_id, CardDeck& deck);
+    // Trade property lists point into storage until the next decision is read
+    Action decision(ReplayTag tag, std::vector<uint32_t> (&storage)[2]);
+    // Whether the decision just read was an overrun, consuming the event if so
+    bool overrun();
+    ReplayEnd end();
+
+private:
+    void expect(ReplayTag tag);
+    const uint8_t* take(size_t n);
+    uint8_t get_u8() { return *this->take(1); };
+    uint16_t get_u16();
+    uint32_t get_u32();
+    uint64_t get_u64();
+
+    std::vector<uint8_t> bytes_;
+    size_t offset_ = 0;
+    ReplayHeader header_;
+};
+
+// Policy answering every decision from a replay log
+class ReplayPolicy : public Policy {
+public:
+    explicit ReplayPolicy(ReplayReader& reader) : reader_(reader) {}
+
+    Action agent_turn(const GameState& state, uint32_t player_index) override;
+    Action auction(const GameState& state, uint32_t player_index, const AuctionView& auction) override;
+    Action trade_offer(const GameState& state, uint32_t player_index, const TradeOffer& offer) override;
+
+private:
+    ReplayReader& reader_;
+    std::vector<uint32_t> storage_[2];
+};
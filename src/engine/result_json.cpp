@@ -0,0 +1,228 @@
+#include "result_json.h"
+
+// Escape a string for safe JSON output
+JsonWriter& JsonWriter::string(std::string_view text) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    out_.push_back('"');
+    for (unsigned char c : text) {
+        switch (c) {
+        case '\\': out_.append("\\\\"); break;
+        case '"':  out_.append("\\\""); break;
+        case '\b': out_.append("\\b");  break;
+        case '\f': out_.append("\\f");  break;
+        case '\n': out_.append("\\n");  break;
+        case '\r': out_.append("\\r");  break;
+        case '\t': out_.append("\\t");  break;
+        default:
+            if (c < 0x20) {
+                out_.append("\\u00");
+                out_.push_back(HEX[c >> 4]);
+                out_.push_back(HEX[c & 0xf]);
+            } else {
+                out_.push_back(static_cast<char>(c));
+            }
+        }
+    }
+    out_.push_back('"');
+    return *this;
+}
+
+void write_json(JsonWriter& out, const PlayerView& p) {
+    out.raw('{');
+
+    out.raw("\"player_index\":").number(p.player_index).raw(',');
+    out.raw("\"cash\":").number(p.cash).raw(',');
+    out.raw("\"position\":").number(p.position).raw(',');
+    out.raw("\"retired\":").boolean(p.retired).raw(',');
+
+    out.raw("\"in_jail\":").boolean(p.in_jail).raw(',');
+    out.raw("\"turns_in_jail\":").number(p.turns_in_jail).raw(',');
+    out.raw("\"jail_free_cards\":").number(p.jail_free_cards).raw(',');
+    out.raw("\"double_rolls\":").number(p.double_rolls).raw(',');
+
+    out.raw("\"railroads_owned\":").number(static_cast<unsigned int>(p.railroads_owned)).raw(',');
+    out.raw("\"utilities_owned\":").number(static_cast<unsigned int>(p.utilities_owned));
+
+    out.raw('}');
+}
+
+void write_json(JsonWriter& out, const PropertyView& pr) {
+    out.raw('{');
+
+    out.raw("\"position\":").number(pr.position).raw(',');
+    out.raw("\"property_id\":").number(pr.property_id).raw(',');
+    out.raw("\"owner_index\":").number(pr.owner_index).raw(',');
+    out.raw("\"is_owned\":").boolean(pr.is_owned).raw(',');
+    out.raw("\"mortgaged\":").boolean(pr.mortgaged).raw(',');
+
+    // PropertyType as integer
+    out.raw("\"type\":").number(static_cast<int>(pr.type)).raw(',');
+
+    out.raw("\"colour_id\":").number(static_cast<unsigned int>(pr.colour_id)).raw(',');
+    out.raw("\"house_price\":").number(pr.house_price).raw(',');
+    out.raw("\"houses\":").number(static_cast<unsigned int>(pr.houses)).raw(',');
+    out.raw("\"hotel\":").boolean(pr.hotel).raw(',');
+
+    out.raw("\"purchase_price\":").number(pr.purchase_price).raw(',');
+    out.raw("\"rent0\":").number(pr.rent0).raw(',');
+    out.raw("\"rent1\":").number(pr.rent1).raw(',');
+    out.raw("\"rent2\":").number(pr.rent2).raw(',');
+    out.raw("\"rent3\":").number(pr.rent3).raw(',');
+    out.raw("\"rent4\":").number(pr.rent4).raw(',');
+    out.raw("\"rentH\":").number(pr.rentH).raw(',');
+
+    out.raw("\"current_rent\":").number(pr.current_rent).raw(',');
+    out.raw("\"is_monopoly\":").boolean(pr.is_monopoly);
+
+    out.raw('}');
+}
+
+void write_json(JsonWriter& out, const GameStateView& s) {
+    out.raw('{');
+
+    out.raw("\"game_id\":").number(s.game_id).raw(',');
+    out.raw("\"houses_remaining\":").number(s.houses_remaining).raw(',');
+    out.raw("\"hotels_remaining\":").number(s.hotels_remaining).raw(',');
+    out.raw("\"current_player_index\":").number(s.current_player_index).raw(',');
+    out.raw("\"owed\":").number(s.owed).raw(',');
+
+    // players array
+    out.raw("\"players\":[");
+    if (s.players && s.players_remaining > 0) {
+        for (uint32_t i = 0; i < s.players_remaining; ++i) {
+            if (i > 0) out.raw(',');
+            write_json(out, s.players[i]);
+        }
+    }
+    out.raw("],");
+
+    // properties array
+    out.raw("\"properties\":[");
+    if (s.properties && s.num_properties > 0) {
+        for (uint32_t i = 0; i < s.num_properties; ++i) {
+            if (i > 0) out.raw(',');
+            write_json(out, s.properties[i]);
+        }
+    }
+    out.raw("],");
+
+    // include counts explicitly as well
+    out.raw("\"players_remaining\":").number(s.players_remaining).raw(',');
+    out.raw("\"num_properties\":").number(s.num_properties);
+
+    out.raw('}');
+}
+
+void write_json(JsonWriter& out, const GameStats& stats) {
+    out.raw("{\"games\":").number(stats.games).raw(',');
+    out.raw("\"total_ns\":").number(stats.total_ns).raw(',');
+    out.raw("\"phases\":{");
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+        if (i > 0) out.raw(',');
+        out.string(phase_name(static_cast<Phase>(i)));
+        out.raw(":{\"calls\":").number(stats.phases[i].calls);
+        out.raw(",\"ns\":").number(stats.phases[i].ns).raw('}');
+    }
+    out.raw("},\"agents\":[");
+    for (size_t i = 0; i < stats.agents.size(); i++) {
+        if (i > 0) out.raw(',');
+        const AgentLatency& agent = stats.agents[i];
+        out.raw("{\"name\":").string(agent.name);
+        for (size_t call = 0; call < NUM_AGENT_CALLS; call++) {
+            const LatencyHistogram& histogram = agent.calls[call];
+            out.raw(',').string(agent_call_name(static_cast<AgentCall>(call)));
+            out.raw(":{\"calls\":").number(histogram.calls);
+            out.raw(",\"total_ns\":").number(histogram.total_ns);
+            out.raw(",\"p50_ns\":").number(histogram.quantile(0.5));
+            out.raw(",\"p99_ns\":").number(histogram.quantile(0.99));
+            out.raw(",\"max_ns\":").number(histogram.max_ns).raw('}');
+        }
+        out.raw('}');
+    }
+    out.raw("]}");
+}
+
+void write_json(JsonWriter& out, const GameResult& r) {
+    out.raw('{');
+
+    out.raw("\"game_id\":").number(r.game_id).raw(',');
+    out.raw("\"turns\":").number(r.turns).raw(',');
+    out.raw("\"winner\":").number(r.winner).raw(',');
+
+    out.raw("\"penalties\":[");
+    for (std::size_t i = 0; i < r.penalties.size(); ++i) {
+        if (i > 0) out.raw(',');
+        out.number(r.penalties[i]);
+    }
+    out.raw("],");
+
+    out.raw("\"player_scores\":[");
+    for (std::size_t i = 0; i < r.player_scores.size(); ++i) {
+        if (i > 0) out.raw(',');
+        out.number(r.player_scores[i]);
+    }
+    out.raw("],");
+
+    out.raw("\"final_state\":");
+    write_json(out, r.final_view());
+    out.raw(',');
+
+    out.raw("\"log_path\":").string(r.log_path);
+    if (!r.overruns.empty()) {
+        out.raw(",\"overruns\":[");
+        for (std::size_t i = 0; i < r.overruns.size(); ++i) {
+            if (i > 0) out.raw(',');
+            out.number(r.overruns[i]);
+        }
+        out.raw(']');
+    }
+    if (r.stats) {
+        out.raw(",\"stats\":");
+        write_json(out, *r.stats);
+    }
+
+    out.raw('}');
+}
+
+void write_error_json(JsonWriter& out, uint64_t game_id, std::string_view error) {
+    out.raw("{\"game_id\":").number(game_id).raw(",\"error\":").string(error).raw('}');
+}
+
+namespace {
+template <class T>
+std::string json_string(const T& value) {
+    std::string text;
+    JsonWriter out(text);
+    write_json(out, value);
+    return text;
+}
+}
+
+std::string json_escape(const std::string& in) {
+    std::string text;
+    JsonWriter(text).string(in);
+    return text;
+}
+
+std::string to_json(const PlayerView& p) {
+    return json_string(p);
+}
+
+std::string to_json(const PropertyView& pr) {
+    return json_string(pr);
+}
+
+std::string to_json(const GameStateView& s) {
+    return json_string(s);
+}
+
+std::string to_json(const GameResult& r) {
+    return json_string(r);
+}
+
+std::string error_json(uint64_t game_id, const std::string& error) {
+    std::string text;
+    JsonWriter out(text);
+    write_error_json(out, game_id, error);
+    return text;
+}
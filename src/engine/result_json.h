@@ -0,0 +1,62 @@
+#pragma once
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "engine.h"
+
+// Appends JSON text to a caller-owned string. Numbers go through std::to_chars, doubles as
+// "%g" would print them (what ostream printed before), so reusing one string between results
+// serializes without allocating once it has grown.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter& raw(std::string_view text) {
+        out_.append(text);
+        return *this;
+    };
+    JsonWriter& raw(char c) {
+        out_.push_back(c);
+        return *this;
+    };
+
+    template <class T>
+    std::enable_if_t<std::is_integral_v<T>, JsonWriter&> number(T value) {
+        char buffer[24];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out_.append(buffer, end);
+        return *this;
+    };
+    JsonWriter& number(double value) {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+        out_.append(buffer, end);
+        return *this;
+    };
+
+    JsonWriter& boolean(bool value) {
+        return this->raw(value ? std::string_view("true") : std::string_view("false"));
+    };
+    // Quoted and escaped
+    JsonWriter& string(std::string_view text);
+
+private:
+    std::string& out_;
+};
+
+// JSON encoding of engine results, shared by the CLI, batch and server modes
+void write_json(JsonWriter& out, const PlayerView& p);
+void write_json(JsonWriter& out, const PropertyView& pr);
+void write_json(JsonWriter& out, const GameStateView& s);
+void write_json(JsonWriter& out, const GameStats& stats);
+void write_json(JsonWriter& out, const GameResult& r);
+void write_error_json(JsonWriter& out, uint64_t game_id, std::string_view error);
+
+std::string json_escape(const std::string& in);
+std::string to_json(const PlayerView& p);
+std::string to_json(const PropertyView& pr);
+std::string to_json(const GameStateView& s);
+std::string to_json(const GameResult& r);
+// Stand-in result line for a game that failed to parse or threw
+std::string error_json(uint64_t game_id, const std::string& error);
@@ -0,0 +1,110 @@
+#include "results_file.h"
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr char RESULTS_MAGIC[4] = {'M', 'R', 'E', 'S'};
+constexpr uint32_t RESULTS_VERSION = 1;
+constexpr uint32_t MAX_PLAYERS = GameState::MAX_PLAYERS;
+constexpr uint32_t NUM_PROPERTIES = GameState::NUM_PROPERTIES;
+
+using Row = std::array<uint8_t, ResultsFile::ROW_SIZE + ResultsFile::FINAL_STATE_SIZE>;
+
+template <class T>
+void put(uint8_t* at, T value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++) {
+        at[i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+}
+
+std::array<uint8_t, ResultsFile::HEADER_SIZE> make_header(bool final_state) {
+    std::array<uint8_t, ResultsFile::HEADER_SIZE> header{};
+    std::memcpy(header.data(), RESULTS_MAGIC, 4);
+    put<uint32_t>(&header[4], RESULTS_VERSION);
+    put<uint32_t>(&header[8], ResultsFile::ROW_SIZE + (final_state ? ResultsFile::FINAL_STATE_SIZE : 0));
+    put<uint32_t>(&header[12], MAX_PLAYERS);
+    put<uint32_t>(&header[16], NUM_PROPERTIES);
+    put<uint32_t>(&header[20], final_state ? ResultsFile::FLAG_FINAL_STATE : 0);
+    return header;
+}
+}
+
+ResultsFile::ResultsFile(const std::string& path, bool final_state) : final_state_(final_state) {
+    const auto header = make_header(final_state);
+
+    std::ifstream existing(path, std::ios::binary);
+    std::array<uint8_t, HEADER_SIZE> found{};
+    const bool has_header = existing && existing.read(reinterpret_cast<char*>(found.data()), HEADER_SIZE);
+    if (has_header && found != header) {
+        throw std::runtime_error("Results file " + path + " has a different layout, use another file");
+    }
+    existing.close();
+
+    out_.open(path, std::ios::binary | std::ios::app);
+    if (!out_) {
+        throw std::runtime_error("Failed to open results file: " + path);
+    }
+    if (!has_header) {
+        out_.write(reinterpret_cast<const char*>(header.data()), HEADER_SIZE);
+    }
+}
+
+void ResultsFile::append(const GameConfig& config, const GameResult& result) {
+    this->put_row(config, &result);
+}
+
+void ResultsFile::append_error(const GameConfig& config) {
+    this->put_row(config, nullptr);
+}
+
+void ResultsFile::flush() {
+    out_.flush();
+}
+
+void ResultsFile::put_row(const GameConfig& config, const GameResult* result) {
+    Row row{};
+    uint8_t* r = row.data();
+    put<uint64_t>(r, config.game_id);
+    put<uint64_t>(r + 8, config.seed);
+    put<int32_t>(r + 20, -1);
+    r[24] = static_cast<uint8_t>(config.agent_specs.size());
+
+    if (result) {
+        put<uint32_t>(r + 16, static_cast<uint32_t>(result->turns));
+        put<int32_t>(r + 20, result->winner);
+        r[25] = 1;
+        for (size_t i = 0; i < result->player_scores.size() && i < MAX_PLAYERS; i++) {
+            put<double>(r + 32 + 8 * i, result->player_scores[i]);
+        }
+        for (size_t i = 0; i < result->penalties.size() && i < MAX_PLAYERS; i++) {
+            put<double>(r + 96 + 8 * i, result->penalties[i]);
+        }
+
+        if (final_state_) {
+            uint8_t* s = r + ROW_SIZE;
+            for (size_t i = 0; i < result->final_players.size() && i < MAX_PLAYERS; i++) {
+                const PlayerView& player = result->final_players[i];
+                put<uint32_t>(s + 4 * i, player.cash);
+                s[32 + i] = static_cast<uint8_t>(player.position);
+                s[40 + i] = (player.retired ? 1 : 0) | (player.in_jail ? 2 : 0);
+                s[48 + i] = static_cast<uint8_t>(player.jail_free_cards);
+            }
+            for (size_t i = 0; i < result->final_properties.size() && i < NUM_PROPERTIES; i++) {
+                const PropertyView& property = result->final_properties[i];
+                s[56 + i] = static_cast<uint8_t>(property.owner_index < MAX_PLAYERS ? property.owner_index : -1);
+                s[84 + i] = property.houses;
+                s[112 + i] = (property.mortgaged ? 1 : 0) | (property.hotel ? 2 : 0);
+            }
+        }
+    } else if (final_state_) {
+        std::memset(r + ROW_SIZE + 56, 0xff, NUM_PROPERTIES);
+    }
+
+    out_.write(reinterpret_cast<const char*>(row.data()), ROW_SIZE + (final_state_ ? FINAL_STATE_SIZE : 0));
+    if (!out_) {
+        throw std::runtime_error("Failed to write results file");
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "engine.h"
+
+// Fixed-width binary results, one row per game, for loading with numpy.memmap
+// (agents/results_file.py has the matching dtype). Little-endian:
+//   header, 64 bytes: magic 'MRES', u32 version, u32 row_size, u32 max_players, u32 num_properties,
+//                     u32 flags (bit 0: rows carry a final state block), zero padding
+//   row: u64 game_id, u64 seed, u32 turns, i32 winner, u8 num_players, u8 ok (0 if the game threw),
+//        6 pad, f64 scores[8], f64 penalties[8]
+//   final state block, if flagged: u32 cash[8], u8 position[8], u8 player_flags[8] (1 retired, 2 in jail),
+//        u8 jail_free_cards[8], i8 owner[28] (-1 unowned), u8 houses[28], u8 property_flags[28]
+//        (1 mortgaged, 2 hotel), 4 pad
+// Seats past num_players are zero. Opening an existing file appends, if its layout matches.
+class ResultsFile {
+public:
+    static constexpr uint32_t HEADER_SIZE = 64;
+    static constexpr uint32_t ROW_SIZE = 160;
+    static constexpr uint32_t FINAL_STATE_SIZE = 144;
+    static constexpr uint32_t FLAG_FINAL_STATE = 0x1;
+
+    // Throws std::runtime_error if the file cannot be opened or has another layout
+    ResultsFile(const std::string& path, bool final_state);
+
+    void append(const GameConfig& config, const GameResult& result);
+    // Row with ok = 0 for a game that threw
+    void append_error(const GameConfig& config);
+    void flush();
+
+private:
+    void put_row(const GameConfig& config, const GameResult* result);
+
+    std::ofstream out_;
+    bool final_state_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <utility>
+
+// Which generator a game draws dice and deck shuffles from.
+// MT19937 is the original engine (std::mt19937_64 + std distributions): its sequences depend on
+// the standard library, but it reproduces every game recorded so far.
+// XOSHIRO256 is xoshiro256** with samplers written out here, so a seed gives the same game everywhere.
+enum class RngBackend : uint8_t {
+    MT19937,
+    XOSHIRO256,
+};
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Independent seed for one stream (a game's dice, an agent, a worker thread) of a base seed
+inline uint64_t derive_seed(uint64_t base, uint64_t stream) {
+    uint64_t state = base ^ splitmix64(stream);
+    return splitmix64(state);
+}
+
+struct Xoshiro256ss {
+    using result_type = uint64_t;
+
+    uint64_t s[4];
+
+    static constexpr result_type min() {
+        return 0;
+    };
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    };
+
+    void seed(uint64_t value) {
+        for (uint64_t& word : s) {
+            word = splitmix64(value);
+        }
+    };
+
+    result_type operator()() {
+        const uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    };
+};
+
+// Uniform in [0, n), by rejection so no value is favoured; same result on every platform
+template <class Rng>
+uint64_t uniform_below(Rng& rng, uint64_t n) {
+    const uint64_t threshold = (0 - n) % n;
+    for (;;) {
+        const uint64_t x = rng();
+        if (x >= threshold) {
+            return x % n;
+        }
+    }
+}
+
+// The generator a game owns. Trivially copyable, so cloning a GameState clones its future rolls.
+struct GameRng {
+    // XOSHIRO256 draws rolls a block at a time: one 64-bit draw below 36^12 is twelve base-36 digits
+    static constexpr uint32_t ROLL_BLOCK = 12;
+    static constexpr uint64_t ROLL_BLOCK_OUTCOMES = 4738381338321616896ULL; // 36^12
+
+    RngBackend backend;
+    std::mt19937_64 legacy;
+    std::uniform_int_distribution<int> legacy_dice{1, 6};
+    Xoshiro256ss fast;
+    std::array<uint8_t, ROLL_BLOCK> roll_block;
+    uint32_t rolls_left;
+
+    void seed(RngBackend backend, uint64_t value) {
+        this->backend = backend;
+        this->reseed(value);
+    };
+
+    // New seed, same backend
+    void reseed(uint64_t value) {
+        if (backend == RngBackend::XOSHIRO256) {
+            fast.seed(value);
+        } else {
+            legacy.seed(value);
+        }
+        rolls_left = 0;
+    };
+
+    // Both dice as one outcome index, (roll_1 - 1) * 6 + (roll_2 - 1)
+    uint32_t roll() {
+        if (backend != RngBackend::XOSHIRO256) {
+            const int roll_1 = legacy_dice(legacy);
+            const int roll_2 = legacy_dice(legacy);
+            return static_cast<uint32_t>((roll_1 - 1) * 6 + (roll_2 - 1));
+        }
+        if (rolls_left == 0) {
+            uint64_t block = uniform_below(fast, ROLL_BLOCK_OUTCOMES);
+            for (uint8_t& outcome : roll_block) {
+                outcome = static_cast<uint8_t>(block % 36);
+                block /= 36;
+            }
+            rolls_left = ROLL_BLOCK;
+        }
+        return roll_block[--rolls_left];
+    };
+
+    template <class It>
+    void shuffle(It first, It last) {
+        if (backend != RngBackend::XOSHIRO256) {
+            std::shuffle(first, last, legacy);
+            return;
+        }
+        // Fisher-Yates, spelled out because std::shuffle differs between standard libraries
+        for (auto n = std::distance(first, last); n > 1; n--) {
+            const auto j = static_cast<decltype(n)>(uniform_below(fast, static_cast<uint64_t>(n)));
+            std::iter_swap(first + (n - 1), first + j);
+        }
+    };
+};
+
+template <class It, class Rng>
+void shuffle_range(It first, It last, Rng& rng) {
+    std::shuffle(first, last, rng);
+}
+
+template <class It>
+void shuffle_range(It first, It last, GameRng& rng) {
+    rng.shuffle(first, last);
+}
+
+// Parses "mt19937" / "xoshiro256"; false for anything else
+inline bool parse_rng_backend(std::string_view name, RngBackend& backend) {
+    if (name == "mt19937") {
+        backend = RngBackend::MT19937;
+    } else if (name == "xoshiro256") {
+        backend = RngBackend::XOSHIRO256;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* rng_backend_name(RngBackend backend) {
+    return backend == RngBackend::XOSHIRO256 ? "xoshiro256" : "mt19937";
+}
@@ -1,10 +1,18 @@
 #include "engine.h"
 #include "agent_adapter.h"
+#include "manifest.h"
+#include "game_runner.h"
+#include "result_json.h"
+#include "results_file.h"
+#include "engine_server.h"
+#include "lockstep_sim.h"
+#include "log.h"
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -12,160 +20,24 @@
 #include <iomanip>
 #include <sstream>
 
-// Escape a string for safe JSON output
-std::string json_escape(const std::string& in) {
-    std::ostringstream oss;
-    oss << '"';
-    for (unsigned char c : in) {
-        switch (c) {
-        case '\\': oss << "\\\\"; break;
-        case '"':  oss << "\\\""; break;
-        case '\b': oss << "\\b";  break;
-        case '\f': oss << "\\f";  break;
-        case '\n': oss << "\\n";  break;
-        case '\r': oss << "\\r";  break;
-        case '\t': oss << "\\t";  break;
-        default:
-            if (c < 0x20) {
-                oss << "\\u"
-                    << std::hex << std::setw(4) << std::setfill('0')
-                    << static_cast<int>(c);
-            } else {
-                oss << c;
-            }
-        }
-    }
-    oss << '"';
-    return oss.str();
-}
-
-std::string to_json(const PlayerView& p) {
-    std::ostringstream oss;
-    oss << '{';
-
-    oss << "\"player_index\":"    << p.player_index    << ',';
-    oss << "\"cash\":"            << p.cash            << ',';
-    oss << "\"position\":"        << p.position        << ',';
-    oss << "\"retired\":"         << (p.retired ? "true" : "false") << ',';
-
-    oss << "\"in_jail\":"         << (p.in_jail ? "true" : "false") << ',';
-    oss << "\"turns_in_jail\":"   << p.turns_in_jail   << ',';
-    oss << "\"jail_free_cards\":" << p.jail_free_cards << ',';
-    oss << "\"double_rolls\":"    << p.double_rolls    << ',';
-
-    oss << "\"railroads_owned\":" << static_cast<unsigned int>(p.railroads_owned) << ',';
-    oss << "\"utilities_owned\":" << static_cast<unsigned int>(p.utilities_owned);
-
-    oss << '}';
-    return oss.str();
-}
-
-std::string to_json(const PropertyView& pr) {
-    std::ostringstream oss;
-    oss << '{';
-
-    oss << "\"position\":"      << pr.position      << ',';
-    oss << "\"property_id\":"   << pr.property_id   << ',';
-    oss << "\"owner_index\":"   << pr.owner_index   << ',';
-    oss << "\"is_owned\":"      << (pr.is_owned ? "true" : "false") << ',';
-    oss << "\"mortgaged\":"     << (pr.mortgaged ? "true" : "false") << ',';
-
-    // PropertyType as integer
-    oss << "\"type\":"          << static_cast<int>(pr.type) << ',';
-
-    oss << "\"colour_id\":"     << static_cast<unsigned int>(pr.colour_id) << ',';
-    oss << "\"house_price\":"   << pr.house_price   << ',';
-    oss << "\"houses\":"        << static_cast<unsigned int>(pr.houses) << ',';
-    oss << "\"hotel\":"         << (pr.hotel ? "true" : "false") << ',';
-
-    oss << "\"purchase_price\":"<< pr.purchase_price<< ',';
-    oss << "\"rent0\":"         << pr.rent0         << ',';
-    oss << "\"rent1\":"         << pr.rent1         << ',';
-    oss << "\"rent2\":"         << pr.rent2         << ',';
-    oss << "\"rent3\":"         << pr.rent3         << ',';
-    oss << "\"rent4\":"         << pr.rent4         << ',';
-    oss << "\"rentH\":"         << pr.rentH         << ',';
-
-    oss << "\"current_rent\":"  << pr.current_rent  << ',';  // ADD COMMA HERE!
-    oss << "\"is_monopoly\":"   << (pr.is_monopoly ? "true" : "false");  // Convert to boolean string
-
-    oss << '}';
-    return oss.str();
-}
-
-std::string to_json(const GameStateView& s) {
-    std::ostringstream oss;
-    oss << '{';
-
-    oss << "\"game_id\":"            << s.game_id            << ',';
-    oss << "\"houses_remaining\":"   << s.houses_remaining   << ',';
-    oss << "\"hotels_remaining\":"   << s.hotels_remaining   << ',';
-    oss << "\"current_player_index\":" << s.current_player_index << ',';
-    oss << "\"owed\":"               << s.owed               << ',';
-
-    // players array
-    oss << "\"players\":[";
-    if (s.players && s.players_remaining > 0) {
-        for (uint32_t i = 0; i < s.players_remaining; ++i) {
-            if (i > 0) oss << ',';
-            oss << to_json(s.players[i]);
-        }
-    }
-    oss << "],";
-
-    // properties array
-    oss << "\"properties\":[";
-    if (s.properties && s.num_properties > 0) {
-        for (uint32_t i = 0; i < s.num_properties; ++i) {
-            if (i > 0) oss << ',';
-            oss << to_json(s.properties[i]);
-        }
-    }
-    oss << "],";
-
-    // include counts explicitly as well
-    oss << "\"players_remaining\":" << s.players_remaining << ',';
-    oss << "\"num_properties\":"    << s.num_properties;
-
-    oss << '}';
-    return oss.str();
-}
-
-std::string to_json(const GameResult& r) {
-    std::ostringstream oss;
-    oss << '{';
-
-    oss << "\"game_id\":" << r.game_id << ',';
-    oss << "\"turns\":"   << r.turns   << ',';
-    oss << "\"winner\":"  << r.winner  << ',';
-
-    oss << "\"penalties\":[";
-    for (std::size_t i = 0; i < r.penalties.size(); ++i) {
-        if (i > 0) oss << ',';
-        oss << r.penalties[i];
-    }
-    oss << "],";
-
-    oss << "\"player_scores\":[";
-    for (std::size_t i = 0; i < r.player_scores.size(); ++i) {
-        if (i > 0) oss << ',';
-        oss << r.player_scores[i];
-    }
-    oss << "],";
-
-    oss << "\"final_state\":" << to_json(r.final_state) << ',';
-
-    oss << "\"log_path\":" << json_escape(r.log_path);
-
-    oss << '}';
-    return oss.str();
-}
-
 [[noreturn]] void usage(const char* prog) {
     std::cerr << "Usage:\n"
               << "  " << prog
               << " <game_id> <seed> <turns>"
-                 " --agent <path> <config_file> <name> [--agent ...]\n";
+                 " --agent <path> <config_file> <name> [--agent ...]\n"
+              << "  " << prog
+              << " --batch <manifest_file|-> [--threads <n, 0 = all cores>] [--results <file> [--final_state]] [--stats]\n"
+              << "    --results appends a fixed-width binary row per game to file instead of printing JSON\n"
+              << "    --stats times each engine phase and agent call per game, and prints the totals last\n"
+              << "  " << prog
+              << " --serve <socket_path> [--threads <n, default all cores>]\n"
+              << "    Games are JSON, one per manifest line or one/an array per length-prefixed --serve frame:\n      "
+                 "{\"game_id\":..,\"seed\":..,\"max_turns\":..,\"agents\":[{\"path\":..,\"config\":{..},\"name\":..}]}\n"
+              << "  " << prog
+              << " --lockstep <games> <policy,policy,...> [--seed <s>] [--max_turns <t>] [--lanes <n>]"
+                 " [--threads <n, 0 = all cores>] [--scalar]\n"
+              << "    Plays games between built-in policies (random, greedy, heuristic) in SIMD lanes,"
+                 " prints one JSON line of totals\n";
     std::exit(EXIT_FAILURE);
 }
 
@@ -192,7 +64,218 @@ std::string read_file(const std::string& path) {
     return buffer.str();
 }
 
+// Runs every game in the manifest in this process, agent libraries stay loaded between games.
+// Emits one NDJSON result per game in manifest order, failed games report an "error" instead.
+// With a results file, games are appended to it as binary rows and only errors are printed.
+// With collect_stats every game collects stats, and a last line sums those of all games that did.
+int run_batch(std::istream& manifest, unsigned int threads, ResultsFile* results, bool collect_stats) {
+    struct Entry {
+        int config_index; // -1 if the line failed to parse
+        std::string error;
+    };
+
+    ManifestParser parser;
+    std::vector<GameConfig> configs;
+    std::vector<Entry> entries;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.find_first_not_of(" \t") == std::string::npos || line[0] == '#') {
+            continue;
+        }
+
+        try {
+            configs.push_back(parser.parse(line));
+            configs.back().collect_stats |= collect_stats;
+            entries.push_back({static_cast<int>(configs.size() - 1), {}});
+        } catch (const std::exception& e) {
+            entries.push_back({-1, e.what()});
+        }
+    }
+
+    // One buffer for every output line, written to stdout in a single call
+    std::string output;
+    JsonWriter out(output);
+    auto emit = [&output]() {
+        output.push_back('\n');
+        std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+        output.clear();
+    };
+
+    // Parse failures are reported in place, between the games around them
+    size_t next_entry = 0;
+    auto report_parse_errors = [&]() {
+        while (next_entry < entries.size() && entries[next_entry].config_index < 0) {
+            write_error_json(out, 0, entries[next_entry].error);
+            emit();
+            next_entry++;
+        }
+    };
+
+    GameStats total_stats;
+    GameRunner runner(threads);
+    runner.run(configs, [&](size_t index, GameRunner::Outcome& outcome) {
+        report_parse_errors();
+        next_entry++;
+        if (outcome.result.stats) {
+            total_stats.merge(*outcome.result.stats);
+        }
+        if (results) {
+            if (outcome.error.empty()) {
+                results->append(configs[index], outcome.result);
+            } else {
+                results->append_error(configs[index]);
+            }
+        }
+        if (!outcome.error.empty()) {
+            write_error_json(out, configs[index].game_id, outcome.error);
+            emit();
+        } else if (!results) {
+            write_json(out, outcome.result);
+            emit();
+        }
+        // Flush per game so callers can consume results as they stream
+        std::cout.flush();
+    });
+    report_parse_errors();
+    if (total_stats.games > 0) {
+        out.raw("{\"stats\":");
+        write_json(out, total_stats);
+        out.raw('}');
+        emit();
+    }
+    std::cout.flush();
+    if (results) {
+        results->flush();
+    }
+    return 0;
+}
+
+// Simplified-rules games between built-in policies, see lockstep_sim.h
+int run_lockstep_mode(const LockstepConfig& config) {
+    LockstepStats stats;
+    try {
+        stats = run_lockstep(config);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::string output;
+    JsonWriter out(output);
+    out.raw("{\"games\":").number(stats.games);
+    out.raw(",\"rounds\":").number(stats.rounds);
+    out.raw(",\"player_turns\":").number(stats.player_turns);
+    out.raw(",\"seats\":[");
+    for (size_t seat = 0; seat < config.seats.size(); seat++) {
+        if (seat > 0) out.raw(',');
+        out.string(lockstep_policy_name(config.seats[seat]));
+    }
+    out.raw("],\"wins\":[");
+    for (size_t seat = 0; seat < config.seats.size(); seat++) {
+        if (seat > 0) out.raw(',');
+        out.number(stats.wins[seat]);
+    }
+    out.raw("],\"draws\":").number(stats.draws);
+    out.raw(",\"seconds\":").number(stats.seconds);
+    out.raw(",\"player_turns_per_s\":").number(stats.seconds > 0 ? stats.player_turns / stats.seconds : 0.0);
+    out.raw(",\"simd\":").boolean(stats.simd);
+    out.raw("}\n");
+    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string_view(argv[1]) == "--serve") {
+        unsigned int threads = 0;
+        if (argc == 5 && std::string_view(argv[3]) == "--threads") {
+            threads = static_cast<unsigned int>(parse_u64(argv[4], "threads"));
+        } else if (argc != 3) {
+            usage(argv[0]);
+        }
+        return serve(argv[2], threads);
+    }
+
+    if (argc >= 4 && std::string_view(argv[1]) == "--lockstep") {
+        LockstepConfig config;
+        config.games = parse_u64(argv[2], "games");
+        std::string_view seats = argv[3];
+        while (!seats.empty()) {
+            const size_t comma = seats.find(',');
+            LockstepPolicy policy;
+            if (!parse_lockstep_policy(seats.substr(0, comma), policy)) {
+                std::cerr << "Invalid policy: " << seats.substr(0, comma) << "\n";
+                return EXIT_FAILURE;
+            }
+            config.seats.push_back(policy);
+            seats = comma == std::string_view::npos ? std::string_view() : seats.substr(comma + 1);
+        }
+        for (int i = 4; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if (arg == "--seed" && i + 1 < argc) {
+                config.seed = parse_u64(argv[++i], "seed");
+            } else if (arg == "--max_turns" && i + 1 < argc) {
+                config.max_turns = static_cast<uint32_t>(parse_u64(argv[++i], "max_turns"));
+            } else if (arg == "--lanes" && i + 1 < argc) {
+                config.lanes = static_cast<uint32_t>(parse_u64(argv[++i], "lanes"));
+            } else if (arg == "--threads" && i + 1 < argc) {
+                config.threads = static_cast<unsigned int>(parse_u64(argv[++i], "threads"));
+            } else if (arg == "--scalar") {
+                config.simd = false;
+            } else {
+                usage(argv[0]);
+            }
+        }
+        return run_lockstep_mode(config);
+    }
+
+    if (argc >= 3 && std::string_view(argv[1]) == "--batch") {
+        std::string_view manifest_path = argv[2];
+        unsigned int threads = 1;
+        std::string results_path;
+        bool final_state = false;
+        bool collect_stats = false;
+        for (int i = 3; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                threads = static_cast<unsigned int>(parse_u64(argv[++i], "threads"));
+            } else if (arg == "--results" && i + 1 < argc) {
+                results_path = argv[++i];
+            } else if (arg == "--final_state") {
+                final_state = true;
+            } else if (arg == "--stats") {
+                collect_stats = true;
+            } else {
+                usage(argv[0]);
+            }
+        }
+        if (final_state && results_path.empty()) {
+            usage(argv[0]);
+        }
+
+        std::unique_ptr<ResultsFile> results;
+        if (!results_path.empty()) {
+            try {
+                results = std::make_unique<ResultsFile>(results_path, final_state);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (manifest_path == "-") {
+            return run_batch(std::cin, threads, results.get(), collect_stats);
+        }
+        std::ifstream manifest{std::string(manifest_path)};
+        if (!manifest) {
+            std::cerr << "Failed to open manifest: " << manifest_path << "\n";
+            return EXIT_FAILURE;
+        }
+        return run_batch(manifest, threads, results.get(), collect_stats);
+    }
+
     if (argc < 4) usage(argv[0]);
 
     uint64_t game_id = parse_u64(argv[1], "game_id");
@@ -243,11 +326,8 @@ int main(int argc, char* argv[]) {
 
     Engine engine(config);
     GameResult result = engine.run();
-    std::cerr << "Engine.run() complete\n";
-    std::cerr << "Players pointer: " << result.final_state.players << "\n";
-    std::cerr << "Players count: " << result.final_state.players_remaining << "\n";
-    std::cerr << "Properties pointer: " << result.final_state.properties << "\n";
-    std::cerr << "Properties count: " << result.final_state.num_properties << "\n";
+    LOG(DEBUG, "Game ", result.game_id, " over after ", result.turns, " turns, ", result.final_state.players_remaining,
+        " players left");
 
     std::cout << to_json(result) << '\n';
     return 0;
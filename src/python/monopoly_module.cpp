@@ -0,0 +1,697 @@
+// CPython extension running games in-process: `import monopoly`
+// Exposes Engine, GameConfig and GameResult, plus a module-level run_games() on a shared Engine.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <exception>
+#include <new>
+#include <string>
+#include <vector>
+#include "agent_pool.h"
+#include "engine.h"
+#include "game_runner.h"
+#include "manifest.h"
+#include "result_json.h"
+
+namespace {
+
+// ---------------------------------------------------------------- GameConfig
+
+struct GameConfigObject {
+    PyObject_HEAD
+    GameConfig config;
+};
+
+extern PyTypeObject GameConfigType;
+
+// Configs are the same dicts a batch manifest holds, parsed by the same ManifestParser
+bool config_from_dict(PyObject* entry, GameConfig& out) {
+    static PyObject* dumps = nullptr;
+    if (!dumps) {
+        PyObject* json = PyImport_ImportModule("json");
+        if (!json) {
+            return false;
+        }
+        dumps = PyObject_GetAttrString(json, "dumps");
+        Py_DECREF(json);
+        if (!dumps) {
+            return false;
+        }
+    }
+
+    PyObject* text = PyObject_CallOneArg(dumps, entry);
+    if (!text) {
+        return false;
+    }
+    Py_ssize_t size = 0;
+    const char* data = PyUnicode_AsUTF8AndSize(text, &size);
+    if (!data) {
+        Py_DECREF(text);
+        return false;
+    }
+
+    try {
+        ManifestParser parser;
+        out = parser.parse(std::string_view(data, static_cast<size_t>(size)));
+    } catch (const std::exception& e) {
+        Py_DECREF(text);
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return false;
+    }
+    Py_DECREF(text);
+    return true;
+}
+
+// Accepts a GameConfig or a manifest-style dict
+bool config_from_object(PyObject* object, GameConfig& out) {
+    if (PyObject_TypeCheck(object, &GameConfigType)) {
+        out = reinterpret_cast<GameConfigObject*>(object)->config;
+        return true;
+    }
+    if (PyDict_Check(object)) {
+        return config_from_dict(object, out);
+    }
+    PyErr_Format(PyExc_TypeError, "expected GameConfig or dict, got %s", Py_TYPE(object)->tp_name);
+    return false;
+}
+
+PyObject* GameConfig_new(PyTypeObject* type, PyObject*, PyObject*) {
+    auto* self = reinterpret_cast<GameConfigObject*>(type->tp_alloc(type, 0));
+    if (self) {
+        new (&self->config) GameConfig{};
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+void GameConfig_dealloc(GameConfigObject* self) {
+    self->config.~GameConfig();
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+// GameConfig({"game_id": ..., ...}) or GameConfig(game_id=..., seed=..., max_turns=..., agents=[...])
+int GameConfig_init(GameConfigObject* self, PyObject* args, PyObject* kwds) {
+    PyObject* entry = nullptr;
+    if (PyTuple_GET_SIZE(args) == 1 && !kwds) {
+        entry = PyTuple_GET_ITEM(args, 0);
+        if (!PyDict_Check(entry)) {
+            PyErr_SetString(PyExc_TypeError, "GameConfig() takes a dict or keyword arguments");
+            return -1;
+        }
+    } else if (PyTuple_GET_SIZE(args) == 0 && kwds) {
+        entry = kwds;
+    } else {
+        PyErr_SetString(PyExc_TypeError, "GameConfig() takes a dict or keyword arguments");
+        return -1;
+    }
+    return config_from_dict(entry, self->config) ? 0 : -1;
+}
+
+PyObject* GameConfig_get_game_id(GameConfigObject* self, void*) {
+    return PyLong_FromUnsignedLongLong(self->config.game_id);
+}
+
+PyObject* GameConfig_get_seed(GameConfigObject* self, void*) {
+    return PyLong_FromUnsignedLongLong(self->config.seed);
+}
+
+PyObject* GameConfig_get_max_turns(GameConfigObject* self, void*) {
+    return PyLong_FromUnsignedLong(self->config.max_turns);
+}
+
+PyObject* GameConfig_get_reshuffle_decks(GameConfigObject* self, void*) {
+    return PyBool_FromLong(self->config.reshuffle_decks);
+}
+
+PyObject* GameConfig_get_rng(GameConfigObject* self, void*) {
+    return PyUnicode_FromString(rng_backend_name(self->config.rng));
+}
+
+PyObject* GameConfig_get_auction(GameConfigObject* self, void*) {
+    return PyUnicode_FromString(auction_mode_name(self->config.auction_mode));
+}
+
+PyObject* GameConfig_get_auction_increment(GameConfigObject* self, void*) {
+    return PyLong_FromUnsignedLong(self->config.auction_increment);
+}
+
+PyObject* GameConfig_get_log_path(GameConfigObject* self, void*) {
+    return PyUnicode_FromStringAndSize(self->config.log_path.data(), static_cast<Py_ssize_t>(self->config.log_path.size()));
+}
+
+PyObject* GameConfig_get_stats(GameConfigObject* self, void*) {
+    return PyBool_FromLong(self->config.collect_stats);
+}
+
+PyObject* GameConfig_get_call_budget_ms(GameConfigObject* self, void*) {
+    return PyLong_FromUnsignedLong(self->config.budget.call_ms);
+}
+
+PyObject* GameConfig_get_game_budget_ms(GameConfigObject* self, void*) {
+    return PyLong_FromUnsignedLong(self->config.budget.game_ms);
+}
+
+PyObject* GameConfig_get_agents(GameConfigObject* self, void*) {
+    PyObject* agents = PyList_New(static_cast<Py_ssize_t>(self->config.agent_specs.size()));
+    if (!agents) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < self->config.agent_specs.size(); i++) {
+        const AgentSpec& spec = self->config.agent_specs[i];
+        PyObject* agent = Py_BuildValue("{s:s#,s:s#,s:s#}",
+            "path", spec.path.data(), static_cast<Py_ssize_t>(spec.path.size()),
+            "name", spec.name.data(), static_cast<Py_ssize_t>(spec.name.size()),
+            "config", spec.config_json.data(), static_cast<Py_ssize_t>(spec.config_json.size()));
+        if (!agent) {
+            Py_DECREF(agents);
+            return nullptr;
+        }
+        PyList_SET_ITEM(agents, static_cast<Py_ssize_t>(i), agent);
+    }
+    return agents;
+}
+
+PyGetSetDef GameConfig_getset[] = {
+    {"game_id", reinterpret_cast<getter>(GameConfig_get_game_id), nullptr, nullptr, nullptr},
+    {"seed", reinterpret_cast<getter>(GameConfig_get_seed), nullptr, nullptr, nullptr},
+    {"max_turns", reinterpret_cast<getter>(GameConfig_get_max_turns), nullptr, nullptr, nullptr},
+    {"reshuffle_decks", reinterpret_cast<getter>(GameConfig_get_reshuffle_decks), nullptr, nullptr, nullptr},
+    {"rng", reinterpret_cast<getter>(GameConfig_get_rng), nullptr, nullptr, nullptr},
+    {"auction", reinterpret_cast<getter>(GameConfig_get_auction), nullptr, "\"rounds\" or \"proxy\"", nullptr},
+    {"auction_increment", reinterpret_cast<getter>(GameConfig_get_auction_increment), nullptr, nullptr, nullptr},
+    {"log_path", reinterpret_cast<getter>(GameConfig_get_log_path), nullptr, nullptr, nullptr},
+    {"stats", reinterpret_cast<getter>(GameConfig_get_stats), nullptr, nullptr, nullptr},
+    {"call_budget_ms", reinterpret_cast<getter>(GameConfig_get_call_budget_ms), nullptr, "0 = unlimited", nullptr},
+    {"game_budget_ms", reinterpret_cast<getter>(GameConfig_get_game_budget_ms), nullptr, "0 = unlimited", nullptr},
+    {"agents", reinterpret_cast<getter>(GameConfig_get_agents), nullptr,
+        "list of {path, name, config} dicts, config as JSON text", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+PyTypeObject GameConfigType = {
+    PyVarObject_HEAD_INIT(nullptr, 0)
+    "monopoly.GameConfig",
+};
+
+// ---------------------------------------------------------------- GameResult
+
+struct GameResultObject {
+    PyObject_HEAD
+    GameResult result;
+    std::string error;
+    Py_ssize_t shape[1];
+};
+
+extern PyTypeObject GameResultType;
+
+PyObject* make_result(GameRunner::Outcome& outcome) {
+    auto* self = PyObject_New(GameResultObject, &GameResultType);
+    if (!self) {
+        return nullptr;
+    }
+    new (&self->result) GameResult(std::move(outcome.result));
+    new (&self->error) std::string(std::move(outcome.error));
+    self->shape[0] = static_cast<Py_ssize_t>(self->result.player_scores.size());
+    return reinterpret_cast<PyObject*>(self);
+}
+
+void GameResult_dealloc(GameResultObject* self) {
+    self->result.~GameResult();
+    self->error.~basic_string();
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+// Buffer protocol: the final player scores as float64[players], e.g. numpy.asarray(result)
+int GameResult_getbuffer(GameResultObject* self, Py_buffer* view, int flags) {
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "GameResult scores are read-only");
+        return -1;
+    }
+    view->obj = Py_NewRef(reinterpret_cast<PyObject*>(self));
+    view->buf = self->result.player_scores.data();
+    view->len = self->shape[0] * static_cast<Py_ssize_t>(sizeof(double));
+    view->readonly = 1;
+    view->itemsize = sizeof(double);
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("d") : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? self->shape : nullptr;
+    view->strides = nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+PyBufferProcs GameResult_as_buffer = {
+    reinterpret_cast<getbufferproc>(GameResult_getbuffer),
+    nullptr,
+};
+
+PyObject* double_tuple(const std::vector<double>& values) {
+    PyObject* tuple = PyTuple_New(static_cast<Py_ssize_t>(values.size()));
+    if (!tuple) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+        PyObject* value = PyFloat_FromDouble(values[i]);
+        if (!value) {
+            Py_DECREF(tuple);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(tuple, static_cast<Py_ssize_t>(i), value);
+    }
+    return tuple;
+}
+
+// Same keys as the JSON result
+PyObject* player_dict(const PlayerView& p) {
+    return Py_BuildValue("{s:I,s:I,s:I,s:O,s:O,s:I,s:I,s:I,s:I,s:I}",
+        "player_index", p.player_index,
+        "cash", p.cash,
+        "position", p.position,
+        "retired", p.retired ? Py_True : Py_False,
+        "in_jail", p.in_jail ? Py_True : Py_False,
+        "turns_in_jail", p.turns_in_jail,
+        "jail_free_cards", p.jail_free_cards,
+        "double_rolls", p.double_rolls,
+        "railroads_owned", static_cast<unsigned int>(p.railroads_owned),
+        "utilities_owned", static_cast<unsigned int>(p.utilities_owned));
+}
+
+PyObject* property_dict(const PropertyView& pr) {
+    return Py_BuildValue("{s:I,s:I,s:I,s:O,s:O,s:i,s:I,s:I,s:I,s:O,s:i,s:i,s:i,s:i,s:i,s:i,s:i,s:i,s:O}",
+        "position", pr.position,
+        "property_id", pr.property_id,
+        "owner_index", pr.owner_index,
+        "is_owned", pr.is_owned ? Py_True : Py_False,
+        "mortgaged", pr.mortgaged ? Py_True : Py_False,
+        "type", static_cast<int>(pr.type),
+        "colour_id", static_cast<unsigned int>(pr.colour_id),
+        "house_price", pr.house_price,
+        "houses", static_cast<unsigned int>(pr.houses),
+        "hotel", pr.hotel ? Py_True : Py_False,
+        "purchase_price", pr.purchase_price,
+        "rent0", pr.rent0,
+        "rent1", pr.rent1,
+        "rent2", pr.rent2,
+        "rent3", pr.rent3,
+        "rent4", pr.rent4,
+        "rentH", pr.rentH,
+        "current_rent", pr.current_rent,
+        "is_monopoly", pr.is_monopoly ? Py_True : Py_False);
+}
+
+template <typename View, typename Convert>
+PyObject* dict_list(const std::vector<View>& views, Convert convert) {
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(views.size()));
+    if (!list) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < views.size(); i++) {
+        PyObject* item = convert(views[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return list;
+}
+
+PyObject* GameResult_get_game_id(GameResultObject* self, void*) {
+    return PyLong_FromUnsignedLongLong(self->result.game_id);
+}
+
+PyObject* GameResult_get_turns(GameResultObject* self, void*) {
+    return PyLong_FromUnsignedLongLong(self->result.turns);
+}
+
+PyObject* GameResult_get_winner(GameResultObject* self, void*) {
+    return PyLong_FromLong(self->error.empty() ? self->result.winner : -1);
+}
+
+PyObject* GameResult_get_player_scores(GameResultObject* self, void*) {
+    return double_tuple(self->result.player_scores);
+}
+
+PyObject* GameResult_get_penalties(GameResultObject* self, void*) {
+    return double_tuple(self->result.penalties);
+}
+
+PyObject* GameResult_get_overruns(GameResultObject* self, void*) {
+    PyObject* tuple = PyTuple_New(static_cast<Py_ssize_t>(self->result.overruns.size()));
+    if (!tuple) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < self->result.overruns.size(); i++) {
+        PyObject* value = PyLong_FromUnsignedLong(self->result.overruns[i]);
+        if (!value) {
+            Py_DECREF(tuple);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(tuple, static_cast<Py_ssize_t>(i), value);
+    }
+    return tuple;
+}
+
+PyObject* GameResult_get_log_path(GameResultObject* self, void*) {
+    return PyUnicode_FromStringAndSize(self->result.log_path.data(), static_cast<Py_ssize_t>(self->result.log_path.size()));
+}
+
+// Same keys as the JSON "stats" block
+PyObject* GameResult_get_stats(GameResultObject* self, void*) {
+    if (!self->result.stats) {
+        Py_RETURN_NONE;
+    }
+    const GameStats& stats = *self->result.stats;
+    PyObject* phases = PyDict_New();
+    if (!phases) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+        PyObject* phase = Py_BuildValue("{s:K,s:K}", "calls", static_cast<unsigned long long>(stats.phases[i].calls),
+            "ns", static_cast<unsigned long long>(stats.phases[i].ns));
+        if (!phase || PyDict_SetItemString(phases, phase_name(static_cast<Phase>(i)), phase) < 0) {
+            Py_XDECREF(phase);
+            Py_DECREF(phases);
+            return nullptr;
+        }
+        Py_DECREF(phase);
+    }
+    PyObject* agents = PyList_New(static_cast<Py_ssize_t>(stats.agents.size()));
+    if (!agents) {
+        Py_DECREF(phases);
+        return nullptr;
+    }
+    for (size_t i = 0; i < stats.agents.size(); i++) {
+        const AgentLatency& agent = stats.agents[i];
+        PyObject* entry = Py_BuildValue("{s:s#}", "name", agent.name.data(), static_cast<Py_ssize_t>(agent.name.size()));
+        for (size_t call = 0; entry && call < NUM_AGENT_CALLS; call++) {
+            const LatencyHistogram& histogram = agent.calls[call];
+            PyObject* latency = Py_BuildValue("{s:K,s:K,s:K,s:K,s:K}",
+                "calls", static_cast<unsigned long long>(histogram.calls),
+                "total_ns", static_cast<unsigned long long>(histogram.total_ns),
+                "p50_ns", static_cast<unsigned long long>(histogram.quantile(0.5)),
+                "p99_ns", static_cast<unsigned long long>(histogram.quantile(0.99)),
+                "max_ns", static_cast<unsigned long long>(histogram.max_ns));
+            if (!latency || PyDict_SetItemString(entry, agent_call_name(static_cast<AgentCall>(call)), latency) < 0) {
+                Py_CLEAR(entry);
+            }
+            Py_XDECREF(latency);
+        }
+        if (!entry) {
+            Py_DECREF(agents);
+            Py_DECREF(phases);
+            return nullptr;
+        }
+        PyList_SET_ITEM(agents, static_cast<Py_ssize_t>(i), entry);
+    }
+    return Py_BuildValue("{s:K,s:K,s:N,s:N}", "games", static_cast<unsigned long long>(stats.games),
+        "total_ns", static_cast<unsigned long long>(stats.total_ns), "phases", phases, "agents", agents);
+}
+
+PyObject* GameResult_get_error(GameResultObject* self, void*) {
+    if (self->error.empty()) {
+        Py_RETURN_NONE;
+    }
+    return PyUnicode_FromStringAndSize(self->error.data(), static_cast<Py_ssize_t>(self->error.size()));
+}
+
+PyObject* GameResult_get_players(GameResultObject* self, void*) {
+    return dict_list(self->result.final_players, player_dict);
+}
+
+PyObject* GameResult_get_properties(GameResultObject* self, void*) {
+    return dict_list(self->result.final_properties, property_dict);
+}
+
+PyGetSetDef GameResult_getset[] = {
+    {"game_id", reinterpret_cast<getter>(GameResult_get_game_id), nullptr, nullptr, nullptr},
+    {"turns", reinterpret_cast<getter>(GameResult_get_turns), nullptr, nullptr, nullptr},
+    {"winner", reinterpret_cast<getter>(GameResult_get_winner), nullptr, "winning player index, -1 if draw/timeout/error", nullptr},
+    {"player_scores", reinterpret_cast<getter>(GameResult_get_player_scores), nullptr, nullptr, nullptr},
+    {"penalties", reinterpret_cast<getter>(GameResult_get_penalties), nullptr, nullptr, nullptr},
+    {"log_path", reinterpret_cast<getter>(GameResult_get_log_path), nullptr, nullptr, nullptr},
+    {"overruns", reinterpret_cast<getter>(GameResult_get_overruns), nullptr,
+        "per player, decisions over the time budget; empty without a budget", nullptr},
+    {"error", reinterpret_cast<getter>(GameResult_get_error), nullptr, "None, or why the game failed", nullptr},
+    {"stats", reinterpret_cast<getter>(GameResult_get_stats), nullptr,
+        "None, or per-phase calls and ns when the config asked for stats", nullptr},
+    {"players", reinterpret_cast<getter>(GameResult_get_players), nullptr, "final player states", nullptr},
+    {"properties", reinterpret_cast<getter>(GameResult_get_properties), nullptr, "final property states", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+// Same text the CLI prints for this game
+PyObject* GameResult_to_json(GameResultObject* self, PyObject*) {
+    std::string json = self->error.empty() ? to_json(self->result) : error_json(self->result.game_id, self->error);
+    return PyUnicode_FromStringAndSize(json.data(), static_cast<Py_ssize_t>(json.size()));
+}
+
+PyMethodDef GameResult_methods[] = {
+    {"to_json", reinterpret_cast<PyCFunction>(GameResult_to_json), METH_NOARGS, "JSON line as printed by monopoly_engine"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyObject* GameResult_repr(GameResultObject* self) {
+    if (!self->error.empty()) {
+        return PyUnicode_FromFormat("<GameResult game_id=%llu error=%s>",
+            static_cast<unsigned long long>(self->result.game_id), self->error.c_str());
+    }
+    return PyUnicode_FromFormat("<GameResult game_id=%llu winner=%d turns=%llu>",
+        static_cast<unsigned long long>(self->result.game_id), self->result.winner,
+        static_cast<unsigned long long>(self->result.turns));
+}
+
+PyTypeObject GameResultType = {
+    PyVarObject_HEAD_INIT(nullptr, 0)
+    "monopoly.GameResult",
+};
+
+// ---------------------------------------------------------------- Engine
+
+// Owns a worker pool and warm agents; games run with the GIL released
+struct EngineObject {
+    PyObject_HEAD
+    AgentPool* pool;
+    GameRunner* runner;
+};
+
+PyObject* Engine_new(PyTypeObject* type, PyObject*, PyObject*) {
+    auto* self = reinterpret_cast<EngineObject*>(type->tp_alloc(type, 0));
+    if (self) {
+        self->pool = nullptr;
+        self->runner = nullptr;
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+void Engine_clear(EngineObject* self) {
+    // Workers and pooled agents may need the GIL themselves (e.g. neat_bridge) while shutting down
+    GameRunner* runner = self->runner;
+    AgentPool* pool = self->pool;
+    self->runner = nullptr;
+    self->pool = nullptr;
+    Py_BEGIN_ALLOW_THREADS
+    delete runner;
+    delete pool;
+    Py_END_ALLOW_THREADS
+}
+
+void Engine_dealloc(EngineObject* self) {
+    Engine_clear(self);
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+// Engine(threads=0), 0 = one worker per hardware thread
+int Engine_init(EngineObject* self, PyObject* args, PyObject* kwds) {
+    static const char* keywords[] = {"threads", nullptr};
+    unsigned int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|I", const_cast<char**>(keywords), &threads)) {
+        return -1;
+    }
+    Engine_clear(self);
+    try {
+        self->pool = new AgentPool();
+        self->runner = new GameRunner(threads, self->pool);
+    } catch (const std::exception& e) {
+        Engine_clear(self);
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return -1;
+    }
+    return 0;
+}
+
+bool engine_ready(EngineObject* self) {
+    if (!self->runner) {
+        PyErr_SetString(PyExc_RuntimeError, "Engine not initialized");
+        return false;
+    }
+    return true;
+}
+
+std::vector<GameRunner::Outcome> run_outcomes(EngineObject* self, const std::vector<GameConfig>& configs) {
+    std::vector<GameRunner::Outcome> outcomes;
+    Py_BEGIN_ALLOW_THREADS
+    outcomes = self->runner->run(configs);
+    Py_END_ALLOW_THREADS
+    return outcomes;
+}
+
+// run_games(configs) -> [GameResult], in order; a failed game carries .error instead of raising
+PyObject* Engine_run_games(EngineObject* self, PyObject* configs_arg) {
+    if (!engine_ready(self)) {
+        return nullptr;
+    }
+    PyObject* sequence = PySequence_Fast(configs_arg, "run_games() expects a sequence of configs");
+    if (!sequence) {
+        return nullptr;
+    }
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+    std::vector<GameConfig> configs(static_cast<size_t>(count));
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (!config_from_object(PySequence_Fast_GET_ITEM(sequence, i), configs[static_cast<size_t>(i)])) {
+            Py_DECREF(sequence);
+            return nullptr;
+        }
+    }
+    Py_DECREF(sequence);
+
+    std::vector<GameRunner::Outcome> outcomes = run_outcomes(self, configs);
+
+    PyObject* results = PyList_New(count);
+    if (!results) {
+        return nullptr;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        GameRunner::Outcome& outcome = outcomes[static_cast<size_t>(i)];
+        if (!outcome.error.empty()) {
+            outcome.result = GameResult{};
+            outcome.result.game_id = configs[static_cast<size_t>(i)].game_id;
+            outcome.result.winner = -1;
+        }
+        PyObject* result = make_result(outcome);
+        if (!result) {
+            Py_DECREF(results);
+            return nullptr;
+        }
+        PyList_SET_ITEM(results, i, result);
+    }
+    return results;
+}
+
+// run_game(config) -> GameResult, raises RuntimeError if the game failed
+PyObject* Engine_run_game(EngineObject* self, PyObject* config_arg) {
+    if (!engine_ready(self)) {
+        return nullptr;
+    }
+    std::vector<GameConfig> configs(1);
+    if (!config_from_object(config_arg, configs[0])) {
+        return nullptr;
+    }
+
+    std::vector<GameRunner::Outcome> outcomes = run_outcomes(self, configs);
+    if (!outcomes[0].error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, outcomes[0].error.c_str());
+        return nullptr;
+    }
+    return make_result(outcomes[0]);
+}
+
+PyObject* Engine_get_threads(EngineObject* self, void*) {
+    return PyLong_FromUnsignedLong(self->runner ? self->runner->threads() : 0);
+}
+
+PyMethodDef Engine_methods[] = {
+    {"run_games", reinterpret_cast<PyCFunction>(Engine_run_games), METH_O,
+        "run_games(configs) -> list of GameResult in input order. Configs are GameConfig or manifest-style dicts."},
+    {"run_game", reinterpret_cast<PyCFunction>(Engine_run_game), METH_O,
+        "run_game(config) -> GameResult, raises RuntimeError if the game fails."},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyGetSetDef Engine_getset[] = {
+    {"threads", reinterpret_cast<getter>(Engine_get_threads), nullptr, "number of worker threads", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+PyTypeObject EngineType = {
+    PyVarObject_HEAD_INIT(nullptr, 0)
+    "monopoly.Engine",
+};
+
+// ---------------------------------------------------------------- module
+
+// Shared Engine behind the module-level run_games, created on first use
+PyObject* default_engine = nullptr;
+
+PyObject* monopoly_run_games(PyObject*, PyObject* configs) {
+    if (!default_engine) {
+        default_engine = PyObject_CallNoArgs(reinterpret_cast<PyObject*>(&EngineType));
+        if (!default_engine) {
+            return nullptr;
+        }
+    }
+    return Engine_run_games(reinterpret_cast<EngineObject*>(default_engine), configs);
+}
+
+PyMethodDef module_methods[] = {
+    {"run_games", monopoly_run_games, METH_O,
+        "run_games(configs) -> list of GameResult, on a shared Engine using all cores."},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyModuleDef monopoly_module = {
+    PyModuleDef_HEAD_INIT,
+    "monopoly",
+    "Monopoly engine running games in-process.",
+    -1,
+    module_methods,
+};
+
+bool ready_type(PyObject* module, PyTypeObject* type, const char* name) {
+    if (PyType_Ready(type) < 0) {
+        return false;
+    }
+    return PyModule_AddObjectRef(module, name, reinterpret_cast<PyObject*>(type)) == 0;
+}
+
+}
+
+PyMODINIT_FUNC PyInit_monopoly(void) {
+    GameConfigType.tp_basicsize = sizeof(GameConfigObject);
+    GameConfigType.tp_flags = Py_TPFLAGS_DEFAULT;
+    GameConfigType.tp_doc = PyDoc_STR("GameConfig(dict) or GameConfig(game_id=, seed=, max_turns=, agents=[...]), same schema as a batch manifest line");
+    GameConfigType.tp_new = GameConfig_new;
+    GameConfigType.tp_init = reinterpret_cast<initproc>(GameConfig_init);
+    GameConfigType.tp_dealloc = reinterpret_cast<destructor>(GameConfig_dealloc);
+    GameConfigType.tp_getset = GameConfig_getset;
+
+    GameResultType.tp_basicsize = sizeof(GameResultObject);
+    GameResultType.tp_flags = Py_TPFLAGS_DEFAULT;
+    GameResultType.tp_doc = PyDoc_STR("Result of one game; supports the buffer protocol over player_scores (float64)");
+    GameResultType.tp_dealloc = reinterpret_cast<destructor>(GameResult_dealloc);
+    GameResultType.tp_repr = reinterpret_cast<reprfunc>(GameResult_repr);
+    GameResultType.tp_as_buffer = &GameResult_as_buffer;
+    GameResultType.tp_getset = GameResult_getset;
+    GameResultType.tp_methods = GameResult_methods;
+
+    EngineType.tp_basicsize = sizeof(EngineObject);
+    EngineType.tp_flags = Py_TPFLAGS_DEFAULT;
+    EngineType.tp_doc = PyDoc_STR("Engine(threads=0): worker threads plus warm agents, games run with the GIL released");
+    EngineType.tp_new = Engine_new;
+    EngineType.tp_init = reinterpret_cast<initproc>(Engine_init);
+    EngineType.tp_dealloc = reinterpret_cast<destructor>(Engine_dealloc);
+    EngineType.tp_methods = Engine_methods;
+    EngineType.tp_getset = Engine_getset;
+
+    PyObject* module = PyModule_Create(&monopoly_module);
+    if (!module) {
+        return nullptr;
+    }
+    if (!ready_type(module, &GameConfigType, "GameConfig")
+        || !ready_type(module, &GameResultType, "GameResult")
+        || !ready_type(module, &EngineType, "Engine")) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}